@@ -0,0 +1,111 @@
+#include "avl_table.h"
+#include "bench_util.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+// AVLTable with pooled nodes vs AVLTable with std::allocator vs std::map:
+// random inserts, random lookups and [lo, hi) range scans over n keys,
+// plus the O(n) bulk build from sorted input
+
+typedef AVLTable<uint64_t, uint64_t> PooledAVL;
+typedef AVLTable<uint64_t, uint64_t, std::allocator<std::pair<const uint64_t, uint64_t>>> HeapAVL;
+
+static void insertInto(std::map<uint64_t, uint64_t>& m, uint64_t k, uint64_t v) { m.insert(std::make_pair(k, v)); }
+template <class T>
+static void insertInto(T& t, uint64_t k, uint64_t v) { t.insert(k, v); }
+
+static const uint64_t* findIn(const std::map<uint64_t, uint64_t>& m, uint64_t k) {
+	std::map<uint64_t, uint64_t>::const_iterator it = m.find(k);
+	return it != m.end() ? &it->second : nullptr;
+}
+template <class T>
+static const uint64_t* findIn(const T& t, uint64_t k) { return t.find(k); }
+
+static uint64_t scan(const std::map<uint64_t, uint64_t>& m, uint64_t lo, uint64_t hi) {
+	uint64_t sum = 0;
+	for (std::map<uint64_t, uint64_t>::const_iterator it = m.lower_bound(lo); it != m.end() && it->first < hi; ++it)
+		sum += it->second;
+	return sum;
+}
+template <class T>
+static uint64_t scan(const T& t, uint64_t lo, uint64_t hi) {
+	uint64_t sum = 0;
+	t.range(lo, hi, [&](const uint64_t&, const uint64_t& v) { sum += v; });
+	return sum;
+}
+
+template <class T>
+void runCase(const std::string& name, const std::vector<uint64_t>& keys, long ranges) {
+	T table;
+	report(name + " insert", bestOf(1, [&] {
+		for (size_t i = 0; i < keys.size(); ++i)
+			insertInto(table, keys[i], i);
+	}), double(keys.size()));
+
+	report(name + " lookup", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < keys.size(); ++i)
+			sum += *findIn(table, keys[(i * 7919) % keys.size()]);
+		doNotOptimize(sum);
+	}), double(keys.size()));
+
+	// keys are uniform over 2^64, so a range of width 2^64 / n * 100 holds ~100
+	uint64_t width = ~uint64_t(0) / keys.size() * 100;
+	report(name + " range scan (~100 keys)", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (long r = 0; r < ranges; ++r) {
+			uint64_t lo = hashMix(uint64_t(r));
+			sum += scan(table, lo, lo + width < lo ? ~uint64_t(0) : lo + width);
+		}
+		doNotOptimize(sum);
+	}), double(ranges));
+}
+
+int main(int argc, char** argv) {
+	long n = argSize(argc, argv, 1000000);
+	long ranges = 10000;
+
+	std::vector<uint64_t> keys(n);
+	for (long i = 0; i < n; ++i)
+		keys[i] = hashMix(uint64_t(i));
+
+	// bulk build first, while the pool hands out fresh, contiguous slots
+	std::vector<std::pair<uint64_t, uint64_t>> sorted;
+	for (long i = 0; i < n; ++i)
+		sorted.push_back(std::make_pair(keys[i], uint64_t(i)));
+	std::sort(sorted.begin(), sorted.end());
+
+	PooledAVL bulk;
+	report("AVLTable bulk build (sorted)", bestOf(1, [&] {
+		bulk = PooledAVL(sorted);
+	}), double(n));
+
+	// nodes were created in key order, so a scan walks memory sequentially
+	uint64_t width = ~uint64_t(0) / uint64_t(n) * 100;
+	report("AVLTable bulk-built range scan", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (long r = 0; r < ranges; ++r) {
+			uint64_t lo = hashMix(uint64_t(r));
+			sum += scan(bulk, lo, lo + width < lo ? ~uint64_t(0) : lo + width);
+		}
+		doNotOptimize(sum);
+	}), double(ranges));
+	bulk.clear();
+
+	report("AVLTable inserts (sorted)", bestOf(1, [&] {
+		PooledAVL t;
+		for (long i = 0; i < n; ++i)
+			t.insert(sorted[i].first, sorted[i].second);
+		doNotOptimize(t);
+	}), double(n));
+
+	std::printf("%ld random keys\n", n);
+	runCase<PooledAVL>("AVLTable (pool)", keys, ranges);
+	runCase<HeapAVL>("AVLTable (new)", keys, ranges);
+	runCase<std::map<uint64_t, uint64_t>>("std::map", keys, ranges);
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include "avl_table.h"
+#include "bench_util.h"
+#include "btree_table.h"
+#include "rb_table.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <vector>
+
+// BTreeTable (1 KB nodes) vs AVLTable and RBTable on random uint64
+// keys: insert, lookup and range scans of 100 consecutive entries, for
+// n = 10^5 up to the size given on the command line (default 10^6)
+//   bench_btree_table [max n]
+
+static const size_t LOOKUPS = 1000000;
+static const size_t SCANS = 20000;
+
+template <class T>
+static void run(const char* name, const std::vector<uint64_t>& keys, size_t n) {
+	std::vector<uint64_t> probes(LOOKUPS);
+	for (size_t q = 0; q < LOOKUPS; ++q)
+		probes[q] = keys[hashMix(q) % n];
+
+	T t;
+	char label[64];
+	std::snprintf(label, sizeof(label), "  %s insert", name);
+	report(label, bestOf(1, [&] {
+		for (size_t i = 0; i < n; ++i)
+			t.insert(keys[i], i);
+	}), double(n));
+
+	std::snprintf(label, sizeof(label), "  %s lookup", name);
+	report(label, bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (size_t q = 0; q < LOOKUPS; ++q)
+			sum += *t.find(probes[q]);
+		doNotOptimize(sum);
+	}), double(LOOKUPS));
+
+	// each scan starts at a present key and covers about 100 entries
+	uint64_t width = ~uint64_t(0) / n * 100;
+	std::snprintf(label, sizeof(label), "  %s range (per entry)", name);
+	size_t visited = 0;
+	double seconds = bestOf(3, [&] {
+		uint64_t sum = 0;
+		visited = 0;
+		for (size_t q = 0; q < SCANS; ++q) {
+			uint64_t lo = probes[q], hi = lo + width < lo ? ~uint64_t(0) : lo + width;
+			t.range(lo, hi, [&](const uint64_t&, const uint64_t& v) {
+				sum += v;
+				++visited;
+			});
+		}
+		doNotOptimize(sum);
+	});
+	report(label, seconds, double(visited));
+}
+
+int main(int argc, char** argv) {
+	size_t maxN = size_t(argSize(argc, argv, 1000000));
+	std::vector<uint64_t> keys(maxN);
+	for (size_t i = 0; i < maxN; ++i)
+		keys[i] = hashMix(i);
+
+	for (size_t n = 100000; n <= maxN; n *= 10) {
+		std::printf("n = %zu\n", n);
+		run<BTreeTable<uint64_t, uint64_t>>("btree", keys, n);
+		run<AVLTable<uint64_t, uint64_t>>("avl", keys, n);
+		run<RBTable<uint64_t, uint64_t>>("rb", keys, n);
+	}
+	return 0;
+}
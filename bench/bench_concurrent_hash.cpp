@@ -0,0 +1,119 @@
+#include "concurrent_hash_table.h"
+#include "bench_util.h"
+#include "hash_table.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ConcurrentHashTable (64 shards, reader-writer locks) vs one HashTable
+// behind a std::mutex, for 1 to 64 threads sharing a fixed total of
+// operations on a prefilled key space, at 90/10 and 50/50 read/write mixes.
+// Writes alternate between overwriting and erasing + reinserting a key.
+// Scaling is bounded by the hardware threads of the machine.
+
+class MutexTable {
+	mutable std::mutex lock;
+	HashTable<uint64_t, uint64_t> table;
+
+public:
+	bool find(uint64_t key, uint64_t& out) const {
+		std::lock_guard<std::mutex> guard(lock);
+		const uint64_t* v = table.find(key);
+		if (!v)
+			return false;
+		out = *v;
+		return true;
+	}
+
+	void write(uint64_t key, uint64_t value, bool overwrite) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (overwrite) {
+			if (uint64_t* v = table.find(key))
+				*v = value;
+		}
+		else {
+			table.erase(key);
+			table.insert(key, value);
+		}
+	}
+
+	void insert(uint64_t key, uint64_t value) {
+		std::lock_guard<std::mutex> guard(lock);
+		table.insert(key, value);
+	}
+};
+
+class ShardedTable {
+	ConcurrentHashTable<uint64_t, uint64_t> table;
+
+public:
+	bool find(uint64_t key, uint64_t& out) const { return table.find(key, out); }
+
+	void write(uint64_t key, uint64_t value, bool overwrite) {
+		if (overwrite)
+			table.update(key, [value](uint64_t& v) { v = value; });
+		else {
+			table.erase(key);
+			table.insert(key, value);
+		}
+	}
+
+	void insert(uint64_t key, uint64_t value) { table.insert(key, value); }
+};
+
+template <class T>
+static double run(T& table, const std::vector<uint64_t>& keys, size_t ops, unsigned threads, unsigned readPercent) {
+	return bestOf(3, [&] {
+		std::vector<std::thread> workers;
+		for (unsigned w = 0; w < threads; ++w)
+			workers.push_back(std::thread([&, w] {
+				uint64_t x = hashMix(w + 1), sum = 0, v = 0;
+				for (size_t i = w; i < ops; i += threads) {
+					x = hashMix(x + i);
+					uint64_t key = keys[x % keys.size()];
+					if ((x >> 40) % 100 < readPercent) {
+						if (table.find(key, v))
+							sum += v;
+					}
+					else
+						table.write(key, i, (x >> 32) & 1);
+				}
+				doNotOptimize(sum);
+			}));
+		for (std::thread& t : workers)
+			t.join();
+	});
+}
+
+int main(int argc, char** argv) {
+	size_t n = size_t(argSize(argc, argv, 1 << 16));
+	size_t ops = size_t(argSize(argc, argv, 2000000, 2));
+	std::vector<uint64_t> keys(n);
+	for (size_t i = 0; i < n; ++i)
+		keys[i] = hashMix(i);
+
+	MutexTable single;
+	ShardedTable sharded;
+	for (size_t i = 0; i < n; ++i) {
+		single.insert(keys[i], i);
+		sharded.insert(keys[i], i);
+	}
+
+	std::printf("%zu keys, %zu operations shared by all threads, %u hardware threads\n",
+		n, ops, std::thread::hardware_concurrency());
+	unsigned mixes[] = { 90, 50 };
+	unsigned counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+	for (unsigned read : mixes) {
+		std::printf("%u%% reads\n", read);
+		for (unsigned threads : counts) {
+			char label[64];
+			std::snprintf(label, sizeof(label), "  %2u threads, one mutex", threads);
+			report(label, run(single, keys, ops, threads, read), double(ops));
+			std::snprintf(label, sizeof(label), "  %2u threads, sharded", threads);
+			report(label, run(sharded, keys, ops, threads, read), double(ops));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include "dense_polynomial.h"
+#include "bench_util.h"
+#include <random>
+
+// Dense univariate multiplication: schoolbook vs Karatsuba vs FFT by size.
+// The crossovers in DensePolynomial::KARATSUBA_THRESHOLD / FFT_THRESHOLD
+// are taken from where the columns of this table cross.
+
+DensePolynomial randomDense(size_t n, std::mt19937_64& rng) {
+	std::uniform_real_distribution<double> coef(-1, 1);
+	std::vector<double> c(n);
+	for (size_t i = 0; i < n; ++i)
+		c[i] = coef(rng);
+	c[n - 1] = 1;
+	return DensePolynomial(c);
+}
+
+double timeMethod(const DensePolynomial& a, const DensePolynomial& b, DensePolynomial::MulMethod method) {
+	int reps = 1;
+	double s;
+	// repeat small products until the measurement is long enough
+	while (true) {
+		s = bestOf(3, [&] {
+			for (int r = 0; r < reps; ++r)
+				doNotOptimize(DensePolynomial::multiply(a, b, method));
+		});
+		if (s > 0.01 || reps > (1 << 20))
+			break;
+		reps *= 4;
+	}
+	return s / reps;
+}
+
+int main(int argc, char** argv) {
+	long maxSize = argSize(argc, argv, 1 << 17);
+	std::mt19937_64 rng(3);
+
+	std::printf("%10s %14s %14s %14s %10s\n", "coefs", "schoolbook us", "karatsuba us", "fft us", "auto");
+	for (long n = 16; n <= maxSize; n *= 2) {
+		DensePolynomial a = randomDense(n, rng), b = randomDense(n, rng);
+
+		double school = n <= (1 << 14) ? timeMethod(a, b, DensePolynomial::MUL_SCHOOLBOOK) : 0;
+		double kara = timeMethod(a, b, DensePolynomial::MUL_KARATSUBA);
+		double fft = timeMethod(a, b, DensePolynomial::MUL_FFT);
+
+		const char* pick = size_t(n) < DensePolynomial::KARATSUBA_THRESHOLD ? "school"
+			: size_t(n) < DensePolynomial::FFT_THRESHOLD ? "karatsuba" : "fft";
+		std::printf("%10ld %14.2f %14.2f %14.2f %10s\n", n, school * 1e6, kara * 1e6, fft * 1e6, pick);
+
+		// also probe the sizes between powers of two around the crossovers
+		long mid = n + n / 2;
+		if (mid <= 2048) {
+			DensePolynomial c = randomDense(mid, rng), d = randomDense(mid, rng);
+			std::printf("%10ld %14.2f %14.2f %14.2f\n", mid,
+				timeMethod(c, d, DensePolynomial::MUL_SCHOOLBOOK) * 1e6,
+				timeMethod(c, d, DensePolynomial::MUL_KARATSUBA) * 1e6,
+				timeMethod(c, d, DensePolynomial::MUL_FFT) * 1e6);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include "polynomial.h"
+#include "dense_polynomial.h"
+#include "bench_util.h"
+#include <random>
+
+// Multi-point evaluation throughput (points/s): blocked Horner and Estrin vs
+// a naive loop calling std::pow per term, which is what evaluating the
+// translator's '^' through Calculate amounts to.
+
+void naiveUnivariate(const Polynomial& p, const std::vector<double>& xs, std::vector<double>& out) {
+	const std::vector<Monomial>& terms = p.monomials();
+	for (size_t i = 0; i < xs.size(); ++i) {
+		double sum = 0;
+		for (size_t t = 0; t < terms.size(); ++t)
+			sum += terms[t].coef * std::pow(xs[i], double(terms[t].degX()));
+		out[i] = sum;
+	}
+}
+
+void naiveMultivariate(const Polynomial& p, const std::vector<double>& xs, const std::vector<double>& ys,
+	const std::vector<double>& zs, std::vector<double>& out) {
+	const std::vector<Monomial>& terms = p.monomials();
+	for (size_t i = 0; i < xs.size(); ++i) {
+		double sum = 0;
+		for (size_t t = 0; t < terms.size(); ++t)
+			sum += terms[t].coef * std::pow(xs[i], double(terms[t].degX()))
+				* std::pow(ys[i], double(terms[t].degY())) * std::pow(zs[i], double(terms[t].degZ()));
+		out[i] = sum;
+	}
+}
+
+void reportRate(const char* name, double seconds, size_t points) {
+	std::printf("%-32s %12.3f Mpoints/s\n", name, points / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+	size_t points = size_t(argSize(argc, argv, 1000000));
+	std::mt19937_64 rng(5);
+	std::uniform_real_distribution<double> dist(-1, 1);
+
+	std::vector<double> xs(points), ys(points), zs(points), out(points);
+	for (size_t i = 0; i < points; ++i) {
+		xs[i] = dist(rng);
+		ys[i] = dist(rng);
+		zs[i] = dist(rng);
+	}
+
+	unsigned degrees[] = { 4, 16, 64, 256 };
+	for (unsigned deg : degrees) {
+		std::vector<double> coefs(deg + 1);
+		for (unsigned i = 0; i <= deg; ++i)
+			coefs[i] = dist(rng);
+		DensePolynomial dense(coefs);
+		Polynomial p = dense.toSparse();
+		std::printf("-- univariate, degree %u, %zu points\n", deg, points);
+
+		reportRate("naive std::pow", bestOf(1, [&] { naiveUnivariate(p, xs, out); }), points);
+		reportRate("horner", bestOf(3, [&] { dense.evaluate(xs, out); }), points);
+		reportRate("estrin", bestOf(3, [&] { dense.evaluate(xs, out, MultiPointEval::ESTRIN); }), points);
+	}
+
+	std::vector<Monomial> terms;
+	std::uniform_int_distribution<unsigned> exp(0, 8);
+	for (int i = 0; i < 60; ++i)
+		terms.push_back(Monomial(dist(rng), exp(rng), exp(rng), exp(rng)));
+	Polynomial multi(terms);
+	std::printf("-- x, y, z, %zu terms, %zu points\n", multi.size(), points);
+	reportRate("naive std::pow", bestOf(1, [&] { naiveMultivariate(multi, xs, ys, zs, out); }), points);
+	reportRate("power tables", bestOf(3, [&] { multi.evaluate(xs, ys, zs, out); }), points);
+
+	return 0;
+}
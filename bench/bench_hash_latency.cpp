@@ -0,0 +1,48 @@
+#include "hash_table.h"
+#include "bench_util.h"
+#include "table_hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Per-insert latency of HashTable growing from empty to n entries, with the
+// table rehashed at once when it fills up and with the incremental resize
+// that moves MIGRATE_SLOTS old slots per insert. Reports latency percentiles
+// of single inserts: rehash pauses show up only in the far tail.
+
+typedef HashTable<uint64_t, uint64_t> Table;
+
+static void run(const char* name, Table::ResizeMode mode, const std::vector<uint64_t>& keys) {
+	typedef std::chrono::steady_clock Clock;
+	std::vector<uint32_t> ns(keys.size());
+	Table table(mode);
+
+	Timer total;
+	Clock::time_point prev = Clock::now();
+	for (size_t i = 0; i < keys.size(); ++i) {
+		table.insert(keys[i], i);
+		Clock::time_point now = Clock::now();
+		ns[i] = uint32_t(std::min<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - prev).count(), UINT32_MAX));
+		prev = now;
+	}
+	double seconds = total.seconds();
+	doNotOptimize(table.size());
+
+	std::sort(ns.begin(), ns.end());
+	auto pct = [&](double p) { return ns[std::min(ns.size() - 1, size_t(p * double(ns.size())))]; };
+	std::printf("%-12s %8.2f ns/insert  p50 %6u  p99 %6u  p99.9 %7u  p99.99 %8u  max %10u ns\n",
+		name, seconds * 1e9 / double(keys.size()), pct(0.5), pct(0.99), pct(0.999), pct(0.9999), ns.back());
+}
+
+int main(int argc, char** argv) {
+	size_t n = size_t(argSize(argc, argv, 10000000));
+	std::vector<uint64_t> keys(n);
+	for (size_t i = 0; i < n; ++i)
+		keys[i] = hashMix(i);
+
+	std::printf("%zu inserts, latency per insert (timer overhead included)\n", n);
+	run("at once", Table::RESIZE_AT_ONCE, keys);
+	run("incremental", Table::RESIZE_INCREMENTAL, keys);
+	return 0;
+}
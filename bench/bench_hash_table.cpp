@@ -0,0 +1,113 @@
+#include "hash_table.h"
+#include "bench_util.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// HashTable (Swiss-table probing) vs std::unordered_map: insert, lookup hit
+// and lookup miss for integer keys at several load factors of a 2^k slot
+// table, then string keys looked up through std::string_view slices
+
+typedef std::unordered_map<uint64_t, uint64_t, TableHash<uint64_t>> StdMap;
+
+static void runLoad(size_t capacity, double load, int reps) {
+	size_t n = size_t(double(capacity) * load);
+	std::vector<uint64_t> keys(n), misses(n);
+	for (size_t i = 0; i < n; ++i) {
+		keys[i] = hashMix(2 * i);
+		misses[i] = hashMix(2 * i + 1);
+	}
+
+	HashTable<uint64_t, uint64_t> table;
+	StdMap map;
+	char label[64];
+	std::snprintf(label, sizeof(label), "load %.2f, n = %zu", load, n);
+	std::printf("%s\n", label);
+
+	report("  HashTable insert", bestOf(1, [&] {
+		table.reserve(capacity - capacity / 8);
+		for (size_t i = 0; i < n; ++i)
+			table.insert(keys[i], i);
+	}), double(n));
+	report("  unordered_map insert", bestOf(1, [&] {
+		map.reserve(n);
+		for (size_t i = 0; i < n; ++i)
+			map.insert(std::make_pair(keys[i], uint64_t(i)));
+	}), double(n));
+
+	report("  HashTable lookup hit", bestOf(reps, [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < n; ++i)
+			sum += *table.find(keys[(i * 7919) % n]);
+		doNotOptimize(sum);
+	}), double(n));
+	report("  unordered_map lookup hit", bestOf(reps, [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < n; ++i)
+			sum += map.find(keys[(i * 7919) % n])->second;
+		doNotOptimize(sum);
+	}), double(n));
+
+	report("  HashTable lookup miss", bestOf(reps, [&] {
+		size_t found = 0;
+		for (size_t i = 0; i < n; ++i)
+			found += table.find(misses[i]) != nullptr;
+		doNotOptimize(found);
+	}), double(n));
+	report("  unordered_map lookup miss", bestOf(reps, [&] {
+		size_t found = 0;
+		for (size_t i = 0; i < n; ++i)
+			found += map.find(misses[i]) != map.end();
+		doNotOptimize(found);
+	}), double(n));
+}
+
+static void runStrings(size_t n, int reps) {
+	// identifiers as the tokenizer sees them: slices of one long text
+	std::string text;
+	std::vector<std::string_view> names;
+	std::vector<size_t> offsets, lengths;
+	for (size_t i = 0; i < n; ++i) {
+		std::string name = "var_" + std::to_string(hashMix(i) % 100000000);
+		offsets.push_back(text.size());
+		lengths.push_back(name.size());
+		text += name + " ";
+	}
+	for (size_t i = 0; i < n; ++i)
+		names.push_back(std::string_view(text).substr(offsets[i], lengths[i]));
+
+	HashTable<std::string, uint64_t> table;
+	std::unordered_map<std::string, uint64_t, TableHash<std::string>> map;
+	for (size_t i = 0; i < n; ++i) {
+		table.insert(std::string(names[i]), i);
+		map.insert(std::make_pair(std::string(names[i]), uint64_t(i)));
+	}
+
+	std::printf("string keys, n = %zu\n", n);
+	report("  HashTable find(string_view)", bestOf(reps, [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < n; ++i)
+			sum += *table.find(names[(i * 7919) % n]);
+		doNotOptimize(sum);
+	}), double(n));
+	report("  unordered_map find(string(view))", bestOf(reps, [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < n; ++i)
+			sum += map.find(std::string(names[(i * 7919) % n]))->second;
+		doNotOptimize(sum);
+	}), double(n));
+}
+
+int main(int argc, char** argv) {
+	size_t capacity = size_t(1) << argSize(argc, argv, 20);
+	int reps = 3;
+
+	double loads[] = { 0.25, 0.5, 0.75, 0.85 };
+	for (double load : loads)
+		runLoad(capacity, load, reps);
+	runStrings(capacity / 2, reps);
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include "List.h"
+#include "bench_util.h"
+#include <forward_list>
+#include <memory>
+
+// Build / copy / traverse of large lists:
+// pooled List<T> vs List<T> with plain new/delete vs std::forward_list
+
+template <class L>
+long long traverse(L& list) {
+	long long sum = 0;
+	for (auto* node = list.get_first(); node != nullptr; node = node->next)
+		sum += node->data;
+	return sum;
+}
+
+template <class T>
+long long traverse(std::forward_list<T>& list) {
+	long long sum = 0;
+	for (const T& value : list)
+		sum += value;
+	return sum;
+}
+
+template <class L>
+void pushFront(L& list, int value) {
+	list.insert_front(value);
+}
+
+template <class T>
+void pushFront(std::forward_list<T>& list, int value) {
+	list.push_front(value);
+}
+
+template <class L>
+void runCase(const std::string& name, long n, int reps) {
+	report(name + " build", bestOf(reps, [&] {
+		L list;
+		for (long i = 0; i < n; ++i)
+			pushFront(list, static_cast<int>(i));
+		doNotOptimize(list);
+	}), static_cast<double>(n));
+
+	L source;
+	for (long i = 0; i < n; ++i)
+		pushFront(source, static_cast<int>(i));
+
+	report(name + " copy", bestOf(reps, [&] {
+		L copy(source);
+		doNotOptimize(copy);
+	}), static_cast<double>(n));
+
+	report(name + " traverse", bestOf(reps, [&] {
+		doNotOptimize(traverse(source));
+	}), static_cast<double>(n));
+}
+
+int main(int argc, char** argv) {
+	long n = argSize(argc, argv, 1000000);
+	int reps = 5;
+
+	std::printf("list of %ld ints, best of %d\n", n, reps);
+	runCase<List<int>>("List<int, PoolAllocator>", n, reps);
+	runCase<List<int, std::allocator<int>>>("List<int, std::allocator>", n, reps);
+	runCase<std::forward_list<int>>("std::forward_list<int>", n, reps);
+
+	List<int> shuffled;
+	for (long i = 0; i < n; ++i)
+		shuffled.insert_front(static_cast<int>((i * 2654435761u) % n));
+	report("List<int> sort (shuffled)", bestOf(1, [&] { shuffled.sort(); }), static_cast<double>(n));
+	report("List<int> move", bestOf(reps, [&] {
+		List<int> moved(std::move(shuffled));
+		shuffled = std::move(moved);
+	}), 1.0);
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include "modint.h"
+#include "polynomial.h"
+#include "bench_util.h"
+#include <vector>
+
+// Modular multiplication modulo 2^61 - 1: Montgomery (ModP61) vs the naive
+// 128-bit product reduced with %, both as raw throughput / latency and as
+// coefficients of a polynomial product
+
+static const uint64_t P = ModP61::MODULUS;
+
+// Same interface as MontgomeryInt, reduced with % after every product
+struct NaiveMod {
+	uint64_t v;
+
+	NaiveMod() : v(0) {}
+	NaiveMod(int x) : v(x < 0 ? P - uint64_t(-x) % P : uint64_t(x) % P) {}
+	explicit NaiveMod(uint64_t x) : v(x % P) {}
+
+	NaiveMod operator+(const NaiveMod& o) const { uint64_t s = v + o.v; return NaiveMod(s >= P ? s - P : s); }
+	NaiveMod operator-(const NaiveMod& o) const { return NaiveMod(v >= o.v ? v - o.v : v - o.v + P); }
+	NaiveMod operator-() const { return NaiveMod(v ? P - v : 0); }
+	NaiveMod operator*(const NaiveMod& o) const { return NaiveMod(uint64_t((unsigned __int128)v * o.v % P)); }
+	NaiveMod& operator+=(const NaiveMod& o) { return *this = *this + o; }
+	NaiveMod& operator*=(const NaiveMod& o) { return *this = *this * o; }
+	bool operator==(const NaiveMod& o) const { return v == o.v; }
+	bool operator!=(const NaiveMod& o) const { return v != o.v; }
+};
+
+template <class M>
+void runCase(const std::string& name, long n, int reps) {
+	std::vector<M> a(n), b(n), c(n);
+	for (long i = 0; i < n; ++i) {
+		a[i] = M(uint64_t((i + 1) * 0x9E3779B97F4A7C15ull));
+		b[i] = M(uint64_t((i + 3) * 0xC2B2AE3D27D4EB4Full));
+	}
+
+	// independent products: limited by multiplier throughput
+	report(name + " throughput", bestOf(reps, [&] {
+		for (long i = 0; i < n; ++i)
+			c[i] = a[i] * b[i];
+		doNotOptimize(c.data());
+	}), double(n));
+
+	// each product depends on the previous one: limited by latency
+	report(name + " latency", bestOf(reps, [&] {
+		M acc = a[0];
+		for (long i = 0; i < n; ++i)
+			acc = acc * b[i];
+		doNotOptimize(acc);
+	}), double(n));
+
+	BasicPolynomial<M> pa, pb;
+	for (unsigned i = 0; i < 300; ++i) {
+		pa.addTerm(a[i % n], i, i % 7, 0);
+		pb.addTerm(b[i % n], i % 11, i, 0);
+	}
+	report(name + " polynomial product", bestOf(reps, [&] {
+		doNotOptimize(pa * pb);
+	}), double(pa.size()) * double(pb.size()));
+}
+
+int main(int argc, char** argv) {
+	long n = argSize(argc, argv, 1 << 20);
+	int reps = 5;
+
+	std::printf("%ld products modulo 2^61 - 1, best of %d\n", n, reps);
+	runCase<NaiveMod>("naive %", n, reps);
+	runCase<ModP61>("Montgomery", n, reps);
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include "avl_table.h"
+#include "bench_util.h"
+#include "rb_table.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <vector>
+
+// select(k) and rank(key) through the subtree sizes of AVLTable and RBTable
+// vs answering the same queries by an in-order scan, at n entries
+
+int main(int argc, char** argv) {
+	size_t n = size_t(argSize(argc, argv, 1000000));
+	size_t queries = 100000, scans = 20;
+	std::vector<uint64_t> keys(n);
+	for (size_t i = 0; i < n; ++i)
+		keys[i] = hashMix(i);
+
+	AVLTable<uint64_t, uint64_t> avl;
+	RBTable<uint64_t, uint64_t> rb;
+	for (size_t i = 0; i < n; ++i) {
+		avl.insert(keys[i], i);
+		rb.insert(keys[i], i);
+	}
+	std::vector<size_t> ks(queries);
+	for (size_t q = 0; q < queries; ++q)
+		ks[q] = hashMix(q + n) % n;
+
+	std::printf("n = %zu random uint64 keys\n", n);
+	report("AVLTable select(k)", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (size_t q = 0; q < queries; ++q)
+			sum += avl.select(ks[q])->value;
+		doNotOptimize(sum);
+	}), double(queries));
+	report("RBTable select(k)", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (size_t q = 0; q < queries; ++q)
+			sum += *rb.select(ks[q]);
+		doNotOptimize(sum);
+	}), double(queries));
+	report("AVLTable select by scan", bestOf(1, [&] {
+		uint64_t sum = 0;
+		for (size_t q = 0; q < scans; ++q) {
+			AVLTable<uint64_t, uint64_t>::Iterator it = avl.begin();
+			for (size_t k = ks[q]; k > 0; --k)
+				++it;
+			sum += it->value;
+		}
+		doNotOptimize(sum);
+	}), double(scans));
+
+	report("AVLTable rank(key)", bestOf(3, [&] {
+		size_t sum = 0;
+		for (size_t q = 0; q < queries; ++q)
+			sum += avl.rank(keys[ks[q]]);
+		doNotOptimize(sum);
+	}), double(queries));
+	report("RBTable rank(key)", bestOf(3, [&] {
+		size_t sum = 0;
+		for (size_t q = 0; q < queries; ++q)
+			sum += rb.rank(keys[ks[q]]);
+		doNotOptimize(sum);
+	}), double(queries));
+	report("RBTable rank by scan", bestOf(1, [&] {
+		size_t sum = 0;
+		for (size_t q = 0; q < scans; ++q) {
+			uint64_t key = keys[ks[q]];
+			rb.for_each([&](const uint64_t& k, const uint64_t&) { sum += k < key; });
+		}
+		doNotOptimize(sum);
+	}), double(scans));
+	return 0;
+}
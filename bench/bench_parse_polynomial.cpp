@@ -0,0 +1,48 @@
+#include "artans.h"
+#include "bench_util.h"
+#include <random>
+
+// Cold-start style workload: compile tens of thousands of polynomial
+// definitions into canonical form
+
+std::string randomDefinition(std::mt19937& rng) {
+	static const char* vars[] = { "x", "y", "z" };
+	std::uniform_int_distribution<int> terms(3, 8), coef(1, 99), exp(1, 4), var(0, 2), pick(0, 3);
+	std::string s;
+
+	int n = terms(rng);
+	for (int t = 0; t < n; ++t) {
+		if (t > 0)
+			s += pick(rng) == 0 ? " - " : " + ";
+		if (pick(rng) == 0) {
+			s += "(" + std::string(vars[var(rng)]) + " + " + std::to_string(coef(rng)) + ")^" + std::to_string(exp(rng));
+			continue;
+		}
+		s += std::to_string(coef(rng));
+		for (int f = pick(rng); f > 0; --f)
+			s += std::string("*") + vars[var(rng)] + "^" + std::to_string(exp(rng));
+	}
+	return s;
+}
+
+int main(int argc, char** argv) {
+	long count = argSize(argc, argv, 50000);
+	std::mt19937 rng(7);
+	std::vector<std::string> definitions;
+	for (long i = 0; i < count; ++i)
+		definitions.push_back(randomDefinition(rng));
+
+	ArithmeticTranslator translator;
+	size_t totalTerms = 0;
+	double seconds = bestOf(3, [&] {
+		totalTerms = 0;
+		for (size_t i = 0; i < definitions.size(); ++i)
+			totalTerms += translator.ToPolynomial(definitions[i]).size();
+	});
+
+	std::printf("%ld definitions, %zu canonical terms\n", count, totalTerms);
+	report("ToPolynomial", seconds, double(count));
+	std::printf("%.0f definitions/s\n", count / seconds);
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+#include "polynomial.h"
+#include "bench_util.h"
+#include <random>
+
+// Sparse polynomial arithmetic on 10^3..10^6 terms
+
+Polynomial randomPolynomial(size_t terms, unsigned maxExp, std::mt19937_64& rng) {
+	std::uniform_int_distribution<unsigned> exp(0, maxExp);
+	std::uniform_real_distribution<double> coef(-1, 1);
+	std::vector<Monomial> monomials;
+	monomials.reserve(terms);
+	for (size_t i = 0; i < terms; ++i)
+		monomials.push_back(Monomial(coef(rng), exp(rng), exp(rng), exp(rng)));
+	return Polynomial(monomials);
+}
+
+int main(int argc, char** argv) {
+	long maxTerms = argSize(argc, argv, 1000000);
+	int reps = 3;
+	std::mt19937_64 rng(42);
+
+	for (long n = 1000; n <= maxTerms; n *= 10) {
+		Polynomial p = randomPolynomial(n, 1000, rng);
+		Polynomial q = randomPolynomial(n, 1000, rng);
+		std::printf("-- %ld terms\n", n);
+
+		report("add", bestOf(reps, [&] { doNotOptimize(p + q); }), double(n));
+		report("sub", bestOf(reps, [&] { doNotOptimize(p - q); }), double(n));
+		report("scalar mul", bestOf(reps, [&] { doNotOptimize(p * 3.5); }), double(n));
+		report("evaluate", bestOf(reps, [&] { doNotOptimize(p.evaluate(0.9, 1.1, 0.7)); }), double(n));
+	}
+
+	for (long n = 100; n <= 1000; n *= 10) {
+		Polynomial p = randomPolynomial(n, 50, rng);
+		Polynomial q = randomPolynomial(n, 50, rng);
+		std::printf("-- %ld x %ld terms product\n", n, n);
+		report("mul", bestOf(reps, [&] { doNotOptimize(p * q); }), double(n) * n);
+	}
+
+	return 0;
+}
@@ -0,0 +1,46 @@
+#include "polynomial.h"
+#include "bench_util.h"
+#include <random>
+
+// Copy latency and memory footprint of copy-on-write polynomials vs deep
+// copies of the term vector, for a polynomial stored in many containers
+
+int main(int argc, char** argv) {
+	long copies = argSize(argc, argv, 1000);
+	std::mt19937_64 rng(9);
+	std::uniform_int_distribution<unsigned> exp(0, 200);
+
+	for (size_t n = 10; n <= 1000000; n *= 10) {
+		std::vector<Monomial> terms;
+		for (size_t i = 0; i < n; ++i)
+			terms.push_back(Monomial(1.5, exp(rng), exp(rng), exp(rng)));
+		Polynomial p(terms);
+		const std::vector<Monomial>& source = p.monomials();
+		std::printf("-- %zu terms, %ld copies\n", p.size(), copies);
+
+		std::vector<Polynomial> shared;
+		shared.reserve(copies);
+		report("cow copy", bestOf(3, [&] {
+			shared.clear();
+			for (long c = 0; c < copies; ++c)
+				shared.push_back(p);
+		}), double(copies));
+
+		long deepCopies = n >= 100000 ? copies / 100 : copies;
+		std::vector<std::vector<Monomial>> deep;
+		deep.reserve(deepCopies);
+		report("deep copy", bestOf(3, [&] {
+			deep.clear();
+			for (long c = 0; c < deepCopies; ++c)
+				deep.push_back(source);
+		}), double(deepCopies));
+
+		double block = double(p.size() * sizeof(Monomial));
+		double cowBytes = copies * double(sizeof(Polynomial)) + block;
+		double deepBytes = copies * (double(sizeof(std::vector<Monomial>)) + block);
+		std::printf("%-40s %10.1f KiB (%.1f bytes/copy)\n", "cow footprint", cowBytes / 1024, cowBytes / copies);
+		std::printf("%-40s %10.1f KiB (%.1f bytes/copy)\n", "deep footprint", deepBytes / 1024, deepBytes / copies);
+	}
+
+	return 0;
+}
@@ -0,0 +1,51 @@
+#include "polynomial.h"
+#include "bench_util.h"
+#include <random>
+
+// Sparse multiplication strategies on 1k x 1k and 10k x 10k term products,
+// for sparse inputs (few collisions) and dense-ish inputs (many collisions)
+
+Polynomial randomPolynomial(size_t terms, unsigned maxExp, std::mt19937_64& rng) {
+	std::uniform_int_distribution<unsigned> exp(0, maxExp);
+	std::uniform_real_distribution<double> coef(-1, 1);
+	std::vector<Monomial> monomials;
+	while (monomials.size() < terms) {
+		monomials.push_back(Monomial(coef(rng), exp(rng), exp(rng), exp(rng)));
+		if (monomials.size() == terms)
+			monomials = Polynomial(monomials).monomials();
+	}
+	return Polynomial(monomials);
+}
+
+void runCase(const char* name, const Polynomial& a, const Polynomial& b, bool withSchoolbook) {
+	double products = double(a.size()) * double(b.size());
+	Polynomial res = a * b;
+	std::printf("-- %s: %zu x %zu terms -> %zu terms\n", name, a.size(), b.size(), res.size());
+
+	if (withSchoolbook)
+		report("schoolbook", bestOf(1, [&] { doNotOptimize(Polynomial::multiply(a, b, Polynomial::MUL_SCHOOLBOOK)); }), products);
+	report("heap", bestOf(1, [&] { doNotOptimize(Polynomial::multiply(a, b, Polynomial::MUL_HEAP)); }), products);
+	report("hash", bestOf(1, [&] { doNotOptimize(Polynomial::multiply(a, b, Polynomial::MUL_HASH)); }), products);
+	report("auto", bestOf(1, [&] { doNotOptimize(a * b); }), products);
+}
+
+int main(int argc, char** argv) {
+	long big = argSize(argc, argv, 10000);
+	std::mt19937_64 rng(1);
+
+	Polynomial s1 = randomPolynomial(1000, 1000, rng), s2 = randomPolynomial(1000, 1000, rng);
+	runCase("sparse 1k", s1, s2, true);
+
+	Polynomial d1 = randomPolynomial(1000, 20, rng), d2 = randomPolynomial(1000, 20, rng);
+	runCase("dense 1k", d1, d2, true);
+
+	// a sparse 10k x 10k product has ~10^8 distinct terms, so the large case
+	// uses bounded exponents to keep the result in memory
+	Polynomial b1 = randomPolynomial(big, 40, rng), b2 = randomPolynomial(big, 40, rng);
+	runCase("dense large", b1, b2, false);
+
+	Polynomial m1 = randomPolynomial(big, 200, rng), m2 = randomPolynomial(big, 200, rng);
+	runCase("medium large", m1, m2, false);
+
+	return 0;
+}
@@ -0,0 +1,45 @@
+#include "polynomial.h"
+#include "bench_util.h"
+#include <random>
+
+// Aggregation of 10^4..10^5 sparse polynomials: k-way merge (sequential and
+// threaded) vs repeated pairwise addition
+
+std::vector<Polynomial> randomPolynomials(size_t count, std::mt19937_64& rng) {
+	std::uniform_int_distribution<unsigned> exp(0, 40), len(5, 40);
+	std::uniform_real_distribution<double> coef(-1, 1);
+	std::vector<Polynomial> res;
+	for (size_t k = 0; k < count; ++k) {
+		std::vector<Monomial> terms;
+		for (unsigned t = len(rng); t > 0; --t)
+			terms.push_back(Monomial(coef(rng), exp(rng), exp(rng), exp(rng)));
+		res.push_back(Polynomial(terms));
+	}
+	return res;
+}
+
+int main(int argc, char** argv) {
+	long maxCount = argSize(argc, argv, 100000);
+	unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+	std::mt19937_64 rng(11);
+
+	for (long count = 10000; count <= maxCount; count *= 10) {
+		std::vector<Polynomial> polys = randomPolynomials(count, rng);
+		size_t terms = 0;
+		for (size_t i = 0; i < polys.size(); ++i)
+			terms += polys[i].size();
+		std::printf("-- %ld polynomials, %zu terms\n", count, terms);
+
+		report("pairwise +=", bestOf(1, [&] {
+			Polynomial acc;
+			for (size_t i = 0; i < polys.size(); ++i)
+				acc += polys[i];
+			doNotOptimize(acc);
+		}), double(terms));
+		report("k-way merge", bestOf(3, [&] { doNotOptimize(Polynomial::sum(polys)); }), double(terms));
+		report("k-way merge, " + std::to_string(threads) + " threads",
+			bestOf(3, [&] { doNotOptimize(Polynomial::sum(polys, threads)); }), double(terms));
+	}
+
+	return 0;
+}
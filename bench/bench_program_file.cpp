@@ -0,0 +1,132 @@
+#include "artans.h"
+#include "bench_util.h"
+#include "program_file.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Startup of a worker that needs n formulas (default 10^5) over a few
+// hundred variable names: reading the infix text and compiling every
+// formula with ToProgram, against mapping a precompiled bundle. Both are
+// timed from a cold page cache, where the OS allows dropping it, up to
+// one evaluation of every program, and of the first SAMPLE only.
+//   bench_program_file [n]
+
+static const size_t SAMPLE = 1000;
+static const size_t NAMES = 300;
+
+// Asks the OS to forget the cached pages of a file
+static void evict(const std::string& path) {
+#if !defined(_WIN32)
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		::close(fd);
+	}
+#endif
+}
+
+// Random formula of about 2 * operands tokens
+static std::string formula(uint64_t seed, unsigned operands) {
+	static const char OPS[] = { '+', '-', '*', '+', '-', '*', '/' };
+	std::string s;
+	unsigned open = 0;
+	for (unsigned i = 0; i < operands; ++i) {
+		uint64_t h = hashMix(seed * 64 + i);
+		// divisors are non-zero constants, so no evaluation throws
+		char op = i > 0 ? OPS[h % sizeof(OPS)] : 0;
+		if (op) {
+			s += ' ';
+			s += op;
+			s += ' ';
+		}
+		if (op != '/' && (h >> 8) % 5 == 0) {
+			s += '(';
+			++open;
+		}
+		if (op == '/' || (h >> 16) % 3 == 0)
+			s += std::to_string(1 + (h >> 24) % 999) + "." + std::to_string((h >> 40) % 100);
+		else
+			s += "v" + std::to_string((h >> 24) % NAMES);
+		if (open && (h >> 48) % 3 == 0) {
+			s += ')';
+			--open;
+		}
+	}
+	s.append(open, ')');
+	return s;
+}
+
+static double fromText(const std::string& path, size_t evaluations, const std::vector<double>& values) {
+	evict(path);
+	Timer t;
+	ArithmeticTranslator translator;
+	std::vector<ExpressionProgram> programs;
+	std::ifstream in(path);
+	std::string line;
+	while (std::getline(in, line))
+		programs.push_back(translator.ToProgram(line));
+	double sum = 0;
+	for (size_t i = 0; i < evaluations; ++i)
+		sum += programs[i].evaluate(values.data());
+	doNotOptimize(sum);
+	return t.seconds();
+}
+
+static double fromBundle(const std::string& path, size_t evaluations, const std::vector<double>& values) {
+	evict(path);
+	Timer t;
+	MappedProgramBundle bundle(path);
+	double sum = 0;
+	for (size_t i = 0; i < evaluations; ++i)
+		sum += bundle.program(i).evaluate(values.data());
+	doNotOptimize(sum);
+	return t.seconds();
+}
+
+int main(int argc, char** argv) {
+	size_t n = size_t(argSize(argc, argv, 100000));
+	std::filesystem::path dir = std::filesystem::temp_directory_path();
+	std::string textPath = (dir / "bench_program_file.txt").string();
+	std::string bundlePath = (dir / "bench_program_file.bundle").string();
+
+	{
+		ArithmeticTranslator translator;
+		std::vector<ExpressionProgram> programs;
+		std::ofstream text(textPath);
+		for (size_t i = 0; i < n; ++i) {
+			std::string f = formula(i, 4 + unsigned(hashMix(i) % 12));
+			text << f << '\n';
+			programs.push_back(translator.ToProgram(f));
+		}
+		saveProgramBundle(bundlePath, programs);
+	}
+	std::printf("n = %zu formulas, text %.1f MB, bundle %.1f MB\n", n,
+		double(std::filesystem::file_size(textPath)) / 1e6, double(std::filesystem::file_size(bundlePath)) / 1e6);
+
+	std::vector<double> values(NAMES);
+	for (size_t i = 0; i < NAMES; ++i)
+		values[i] = 1.0 + double(i) / NAMES;
+
+	size_t sample = std::min(SAMPLE, n);
+	report("  compile text, run all", fromText(textPath, n, values), double(n));
+	report("  map bundle, run all", fromBundle(bundlePath, n, values), double(n));
+	report("  compile text, run first 1000", fromText(textPath, sample, values), double(n));
+	report("  map bundle, run first 1000", fromBundle(bundlePath, sample, values), double(n));
+
+	MappedProgramBundle bundle(bundlePath);
+	report("  bundle verify checksum", bestOf(1, [&] { doNotOptimize(bundle.verify()); }), double(n));
+
+	std::remove(textPath.c_str());
+	std::remove(bundlePath.c_str());
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include "rb_table.h"
+#include "bench_util.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+// RBTable (index-linked nodes in one vector) vs std::map at n entries:
+// bytes per entry, random insert, lookup and erase throughput
+
+static size_t mapBytes = 0;
+
+// Counts the bytes std::map requests (malloc's own headers not included)
+template <class T>
+struct CountingAllocator {
+	typedef T value_type;
+
+	CountingAllocator() {}
+	template <class U>
+	CountingAllocator(const CountingAllocator<U>&) {}
+
+	T* allocate(size_t n) {
+		mapBytes += n * sizeof(T);
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, size_t n) {
+		mapBytes -= n * sizeof(T);
+		std::allocator<T>().deallocate(p, n);
+	}
+};
+
+template <class T, class U>
+bool operator==(const CountingAllocator<T>&, const CountingAllocator<U>&) { return true; }
+template <class T, class U>
+bool operator!=(const CountingAllocator<T>&, const CountingAllocator<U>&) { return false; }
+
+typedef std::map<uint64_t, uint64_t, std::less<uint64_t>, CountingAllocator<std::pair<const uint64_t, uint64_t>>> Map;
+
+int main(int argc, char** argv) {
+	long n = argSize(argc, argv, 1000000);
+	std::vector<uint64_t> keys(n);
+	for (long i = 0; i < n; ++i)
+		keys[i] = hashMix(uint64_t(i));
+
+	RBTable<uint64_t, uint64_t> rb;
+	Map map;
+
+	std::printf("%ld random uint64 -> uint64 entries\n", n);
+	report("RBTable insert", bestOf(1, [&] {
+		for (long i = 0; i < n; ++i)
+			rb.insert(keys[i], uint64_t(i));
+	}), double(n));
+	report("std::map insert", bestOf(1, [&] {
+		for (long i = 0; i < n; ++i)
+			map.insert(std::make_pair(keys[i], uint64_t(i)));
+	}), double(n));
+
+	std::printf("%-40s %10.1f bytes/entry\n", "RBTable memory", double(rb.memoryUsage()) / double(n));
+	std::printf("%-40s %10.1f bytes/entry (+ malloc headers)\n", "std::map memory", double(mapBytes) / double(n));
+
+	report("RBTable lookup", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (long i = 0; i < n; ++i)
+			sum += *rb.find(keys[(i * 7919) % n]);
+		doNotOptimize(sum);
+	}), double(n));
+	report("std::map lookup", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (long i = 0; i < n; ++i)
+			sum += map.find(keys[(i * 7919) % n])->second;
+		doNotOptimize(sum);
+	}), double(n));
+
+	report("RBTable erase", bestOf(1, [&] {
+		for (long i = 0; i < n; ++i)
+			rb.erase(keys[(i * 7919) % n]);
+	}), double(n));
+	report("std::map erase", bestOf(1, [&] {
+		for (long i = 0; i < n; ++i)
+			map.erase(keys[(i * 7919) % n]);
+	}), double(n));
+
+	// the second round reuses the free list instead of growing the vector
+	report("RBTable insert into freed slots", bestOf(1, [&] {
+		for (long i = 0; i < n; ++i)
+			rb.insert(keys[i], uint64_t(i));
+	}), double(n));
+	return 0;
+}
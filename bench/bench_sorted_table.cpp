@@ -0,0 +1,91 @@
+#include "sorted_table.h"
+#include "bench_util.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Random lookups (half hits, half misses) in n keys, n = 10^3 .. max:
+// std::map vs binary search over a sorted vector vs SortedTable (Eytzinger)
+// with single and batched lookups
+
+static uint64_t mix(uint64_t x) {
+	x ^= x >> 33;
+	x *= 0xFF51AFD7ED558CCDull;
+	x ^= x >> 33;
+	return x;
+}
+
+static void runSize(long n, long lookups, int reps) {
+	std::vector<std::pair<uint64_t, uint64_t>> items;
+	items.reserve(n);
+	for (long i = 0; i < n; ++i)
+		items.push_back(std::make_pair(mix(uint64_t(i)) | 1, uint64_t(i)));
+
+	// odd keys are present, even ones miss
+	std::vector<uint64_t> queries(lookups);
+	for (long i = 0; i < lookups; ++i) {
+		uint64_t k = mix(mix(uint64_t(i)) % uint64_t(n));
+		queries[i] = (i & 1) ? (k | 1) : (k & ~uint64_t(1));
+	}
+
+	std::printf("n = %ld\n", n);
+
+	SortedTable<uint64_t, uint64_t> table;
+	report("  SortedTable build", bestOf(1, [&] {
+		table = SortedTable<uint64_t, uint64_t>(items);
+	}), double(n));
+
+	std::map<uint64_t, uint64_t> map(items.begin(), items.end());
+	std::sort(items.begin(), items.end());
+	std::vector<uint64_t> sorted(n);
+	for (long i = 0; i < n; ++i)
+		sorted[i] = items[i].first;
+
+	report("  std::map::find", bestOf(reps, [&] {
+		uint64_t sum = 0;
+		for (long i = 0; i < lookups; ++i) {
+			std::map<uint64_t, uint64_t>::const_iterator it = map.find(queries[i]);
+			sum += it != map.end() ? it->second : 0;
+		}
+		doNotOptimize(sum);
+	}), double(lookups));
+
+	report("  std::lower_bound", bestOf(reps, [&] {
+		uint64_t sum = 0;
+		for (long i = 0; i < lookups; ++i) {
+			std::vector<uint64_t>::const_iterator it = std::lower_bound(sorted.begin(), sorted.end(), queries[i]);
+			sum += (it != sorted.end() && *it == queries[i]) ? items[it - sorted.begin()].second : 0;
+		}
+		doNotOptimize(sum);
+	}), double(lookups));
+
+	report("  SortedTable::find", bestOf(reps, [&] {
+		uint64_t sum = 0;
+		for (long i = 0; i < lookups; ++i) {
+			const uint64_t* v = table.find(queries[i]);
+			sum += v ? *v : 0;
+		}
+		doNotOptimize(sum);
+	}), double(lookups));
+
+	std::vector<const uint64_t*> out(lookups);
+	report("  SortedTable::findBatch", bestOf(reps, [&] {
+		static_cast<const SortedTable<uint64_t, uint64_t>&>(table).findBatch(queries, out);
+		uint64_t sum = 0;
+		for (long i = 0; i < lookups; ++i)
+			sum += out[i] ? *out[i] : 0;
+		doNotOptimize(sum);
+	}), double(lookups));
+}
+
+int main(int argc, char** argv) {
+	long maxN = argSize(argc, argv, 10000000);
+	long lookups = argSize(argc, argv, 1000000, 2);
+	int reps = 3;
+
+	std::printf("%ld random lookups per size, best of %d\n", lookups, reps);
+	for (long n = 1000; n <= maxN; n *= 10)
+		runSize(n, lookups, reps);
+	return 0;
+}
@@ -0,0 +1,118 @@
+#include "artans.h"
+#include "bench_util.h"
+#include "hash_table.h"
+#include "string_interner.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Identifiers as interned IDs against identifiers as text:
+//  - intern() of tokens drawn from a vocabulary (the hit path the
+//    tokenizer takes once a name is known)
+//  - symbol table lookups by std::string_view against lookups by ID
+//  - memory for the variable names of n compiled formulas (default 10^5):
+//    one std::string per slot and program, against a 4-byte ID per slot
+//    and each name once in the interner
+//   bench_string_interner [n]
+
+static const size_t TOKENS = 1000000;
+static const char* STEMS[] = { "x", "rate", "principal", "quarterlyRevenue", "unitPrice", "discountFactor",
+	"temperatureKelvin", "accountBalance" };
+static const size_t STEM_COUNT = sizeof(STEMS) / sizeof(STEMS[0]);
+
+static std::vector<std::string> vocabulary(size_t size) {
+	std::vector<std::string> names(size);
+	for (size_t i = 0; i < size; ++i)
+		names[i] = STEMS[i % STEM_COUNT] + std::to_string(i / STEM_COUNT);
+	return names;
+}
+
+static void lookups(size_t vocabularySize) {
+	std::vector<std::string> names = vocabulary(vocabularySize);
+	std::vector<std::string> tokens(TOKENS);
+	for (size_t i = 0; i < TOKENS; ++i)
+		tokens[i] = names[hashMix(i) % vocabularySize];
+
+	StringInterner interner;
+	HashTable<std::string, double> byText;
+	HashTable<uint32_t, double> byId;
+	for (size_t i = 0; i < vocabularySize; ++i) {
+		byText.insert(names[i], double(i));
+		byId.insert(interner.intern(names[i]), double(i));
+	}
+	std::vector<uint32_t> ids(TOKENS);
+	for (size_t i = 0; i < TOKENS; ++i)
+		ids[i] = interner.find(tokens[i]);
+
+	std::printf("vocabulary %zu names, %zu tokens\n", vocabularySize, TOKENS);
+	report("  intern (known names)", bestOf(3, [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < TOKENS; ++i)
+			sum += interner.intern(tokens[i]);
+		doNotOptimize(sum);
+	}), double(TOKENS));
+	report("  symbol lookup by string_view", bestOf(3, [&] {
+		double sum = 0;
+		for (size_t i = 0; i < TOKENS; ++i)
+			sum += *byText.find(std::string_view(tokens[i]));
+		doNotOptimize(sum);
+	}), double(TOKENS));
+	report("  symbol lookup by ID", bestOf(3, [&] {
+		double sum = 0;
+		for (size_t i = 0; i < TOKENS; ++i)
+			sum += *byId.find(ids[i]);
+		doNotOptimize(sum);
+	}), double(TOKENS));
+	report("  compare by text", bestOf(3, [&] {
+		size_t equal = 0;
+		for (size_t i = 1; i < TOKENS; ++i)
+			equal += tokens[i] == tokens[i - 1];
+		doNotOptimize(equal);
+	}), double(TOKENS));
+	report("  compare by ID", bestOf(3, [&] {
+		size_t equal = 0;
+		for (size_t i = 1; i < TOKENS; ++i)
+			equal += ids[i] == ids[i - 1];
+		doNotOptimize(equal);
+	}), double(TOKENS));
+}
+
+int main(int argc, char** argv) {
+	size_t n = size_t(argSize(argc, argv, 100000));
+	lookups(300);
+	lookups(100000);
+
+	std::vector<std::string> names = vocabulary(300);
+	ArithmeticTranslator translator;
+	std::vector<ExpressionProgram> programs;
+	programs.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		std::string f = names[hashMix(i) % names.size()];
+		for (size_t k = 1; k < 4 + hashMix(i + n) % 8; ++k)
+			f += " * " + names[hashMix(i * 16 + k) % names.size()];
+		programs.push_back(translator.ToProgram(f));
+	}
+
+	// a std::string per slot, plus its heap block when past the small
+	// string buffer, against an ID per slot and the interner's text, views
+	// and hash slots
+	size_t slots = 0, textBytes = 0;
+	std::string probe;
+	for (const ExpressionProgram& p : programs) {
+		slots += p.variableCount();
+		for (size_t s = 0; s < p.variableCount(); ++s) {
+			probe.assign(p.variable(s));
+			if (probe.capacity() > std::string().capacity())
+				textBytes += probe.capacity() + 1;
+		}
+	}
+	const StringInterner& interner = *translator.interner();
+	size_t asText = slots * sizeof(std::string) + textBytes;
+	size_t interned = slots * sizeof(uint32_t) + interner.textBytes()
+		+ interner.size() * (sizeof(std::string_view) + 2 * (sizeof(std::string_view) + sizeof(uint32_t)));
+	std::printf("%zu formulas, %zu variable slots, %zu distinct names\n", n, slots, interner.size());
+	std::printf("  names as std::string per slot    %10.2f MB\n", double(asText) / 1e6);
+	std::printf("  names interned                   %10.2f MB\n", double(interned) / 1e6);
+	return 0;
+}
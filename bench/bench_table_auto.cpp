@@ -0,0 +1,48 @@
+#include "table.h"
+#include "bench_util.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A catalog built from empty up to n entries with four lookups per insert,
+// for n = 10 .. 10^6, through Table with each fixed backend and the two
+// auto policies. The unsorted and sorted backends are quadratic to build
+// and run only up to 10^4 entries.
+
+typedef Table<uint64_t, uint64_t> U64Table;
+
+static const char* NAMES[] = { "unsorted", "sorted", "avl", "rb", "hash", "auto", "auto ordered" };
+
+static double run(U64Table::Backend backend, const std::vector<uint64_t>& keys, size_t n) {
+	return bestOf(n < 100000 ? 3 : 1, [&] {
+		U64Table t(backend);
+		uint64_t sum = 0, x = 1;
+		for (size_t i = 0; i < n; ++i) {
+			t.insert(keys[i], i);
+			for (int r = 0; r < 4; ++r) {
+				x = hashMix(x);
+				if (const uint64_t* v = t.find(keys[x % (i + 1)]))
+					sum += *v;
+			}
+		}
+		doNotOptimize(sum);
+	});
+}
+
+int main(int argc, char** argv) {
+	size_t maxN = size_t(argSize(argc, argv, 1000000));
+	std::vector<uint64_t> keys(maxN);
+	for (size_t i = 0; i < maxN; ++i)
+		keys[i] = hashMix(i);
+
+	for (size_t n = 10; n <= maxN; n *= 10) {
+		std::printf("n = %zu, 1 insert + 4 lookups per entry\n", n);
+		for (int b = U64Table::BACKEND_UNSORTED; b <= U64Table::BACKEND_AUTO_ORDERED; ++b) {
+			if (n > 10000 && (b == U64Table::BACKEND_UNSORTED || b == U64Table::BACKEND_SORTED))
+				continue;
+			report(std::string("  ") + NAMES[b], run(U64Table::Backend(b), keys, n), double(5 * n));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include "bench_util.h"
+#include "hash_table.h"
+#include "sorted_table.h"
+#include "table_file.h"
+#include "table_hash.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Cold start of a table of n uint64 -> uint64 entries (default 10^6):
+// parsing "key value" text lines into a SortedTable or HashTable, against
+// mapping a table file and searching it in place. Each start is timed up to
+// the answer of the first LOOKUPS random lookups, after the files are
+// dropped from the page cache where the OS allows it.
+//   bench_table_file [n]
+
+static const size_t LOOKUPS = 1000;
+
+// Asks the OS to forget the cached pages of a file
+static void evict(const std::string& path) {
+#if !defined(_WIN32)
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		::close(fd);
+	}
+#endif
+}
+
+template <class T>
+static double fromText(const std::string& path, const std::vector<uint64_t>& probes) {
+	evict(path);
+	Timer t;
+	std::ifstream in(path);
+	std::vector<std::pair<uint64_t, uint64_t>> items;
+	uint64_t k, v;
+	while (in >> k >> v)
+		items.emplace_back(k, v);
+	T table;
+	if constexpr (std::is_constructible_v<T, std::vector<std::pair<uint64_t, uint64_t>>>)
+		table = T(std::move(items));
+	else {
+		table.reserve(items.size());
+		for (auto& e : items)
+			table.insert(e.first, e.second);
+	}
+	uint64_t sum = 0;
+	for (uint64_t p : probes)
+		sum += *table.find(p);
+	doNotOptimize(sum);
+	return t.seconds();
+}
+
+template <class T>
+static double fromMapped(const std::string& path, const std::vector<uint64_t>& probes) {
+	evict(path);
+	Timer t;
+	T table(path);
+	uint64_t sum = 0;
+	for (uint64_t p : probes)
+		sum += *table.find(p);
+	doNotOptimize(sum);
+	return t.seconds();
+}
+
+int main(int argc, char** argv) {
+	size_t n = size_t(argSize(argc, argv, 1000000));
+	std::filesystem::path dir = std::filesystem::temp_directory_path();
+	std::string textPath = (dir / "bench_table_file.txt").string();
+	std::string sortedPath = (dir / "bench_table_file.sorted").string();
+	std::string hashPath = (dir / "bench_table_file.hash").string();
+
+	SortedTable<uint64_t, uint64_t> sorted;
+	HashTable<uint64_t, uint64_t> hash;
+	{
+		std::vector<std::pair<uint64_t, uint64_t>> items(n);
+		std::ofstream text(textPath);
+		for (size_t i = 0; i < n; ++i) {
+			items[i] = { hashMix(i), i };
+			text << items[i].first << ' ' << i << '\n';
+			hash.insert(items[i].first, i);
+		}
+		sorted = SortedTable<uint64_t, uint64_t>(std::move(items));
+	}
+	saveTable(sortedPath, sorted);
+	saveTable(hashPath, hash);
+
+	std::vector<uint64_t> probes(LOOKUPS);
+	for (size_t q = 0; q < LOOKUPS; ++q)
+		probes[q] = hashMix(hashMix(q) % n);
+
+	std::printf("n = %zu, cold start + %zu lookups\n", n, LOOKUPS);
+	report("  sorted parse text", fromText<SortedTable<uint64_t, uint64_t>>(textPath, probes), double(n));
+	report("  sorted map file", fromMapped<MappedSortedTable<uint64_t, uint64_t>>(sortedPath, probes), double(n));
+	report("  hash parse text", fromText<HashTable<uint64_t, uint64_t>>(textPath, probes), double(n));
+	report("  hash map file", fromMapped<MappedHashTable<uint64_t, uint64_t>>(hashPath, probes), double(n));
+
+	MappedHashTable<uint64_t, uint64_t> check(hashPath);
+	report("  hash verify checksum", bestOf(1, [&] { doNotOptimize(check.verify()); }), double(n));
+
+	std::remove(textPath.c_str());
+	std::remove(sortedPath.c_str());
+	std::remove(hashPath.c_str());
+	return 0;
+}
@@ -0,0 +1,332 @@
+#include "table.h"
+#include "bench_util.h"
+#include "concurrent_hash_table.h"
+#include "hash_table.h"
+#include "table_hash.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Standard workloads against every table implementation, for picking a
+// table type from data: the five Table backends, HashTable resizing
+// incrementally, and ConcurrentHashTable from one thread and from
+// CONTENDED_THREADS threads at once. Each run fills a table with n keys,
+// then times single operations drawn from a key distribution at a
+// read/write mix until MAX_OPS operations or TIME_BUDGET seconds. A write
+// erases a drawn key or puts the last erased key back, so the size stays
+// at n or n - 1 (n - threads when threads share the operations).
+// Workloads: uniform, Zipfian (s = 0.99) and sequential uint64 keys, and
+// strings of 4 to 64 characters drawn uniformly and Zipfian.
+// Output is one CSV row (or JSON object) per run with throughput, latency
+// percentiles of single operations (timer overhead included) and heap bytes
+// per entry after the fill.
+//   bench_tables [n] [--json]
+
+static constexpr size_t MAX_OPS = 200000;
+static constexpr double TIME_BUDGET = 0.25;
+static constexpr unsigned CONTENDED_THREADS = 4;
+
+// Live heap bytes, through replaced global operator new / delete that keep
+// the size of each block in front of it. The AVL nodes come from the
+// process-wide pool (aligned new, not counted here), which recycles slots
+// between runs, so they are counted as one node each instead. Atomic, as
+// the contended runs allocate from several threads.
+static std::atomic<size_t> liveBytes(0);
+static constexpr size_t HEADER = 16;
+
+static void* countedAlloc(size_t size) {
+	char* p = static_cast<char*>(std::malloc(size + HEADER));
+	if (!p)
+		throw std::bad_alloc();
+	*reinterpret_cast<size_t*>(p) = size;
+	liveBytes.fetch_add(size, std::memory_order_relaxed);
+	return p + HEADER;
+}
+
+static void countedFree(void* ptr) noexcept {
+	if (!ptr)
+		return;
+	char* p = static_cast<char*>(ptr) - HEADER;
+	liveBytes.fetch_sub(*reinterpret_cast<size_t*>(p), std::memory_order_relaxed);
+	std::free(p);
+}
+
+// Every unaligned form, so that each new meets its own delete
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { countedFree(ptr); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return countedAlloc(size);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+
+enum Distribution { UNIFORM, ZIPF, SEQUENTIAL };
+
+static const char* DIST_NAMES[] = { "uniform", "zipf", "sequential" };
+static const char* BACKEND_NAMES[] = { "unsorted", "sorted", "avl", "rb", "hash" };
+
+struct Result {
+	std::string keys, dist, backend;
+	unsigned readPercent;
+	size_t n, ops;
+	double opsPerSec, p50, p90, p99, p999, bytesPerEntry;
+};
+
+// Indices into the key array in access order
+static std::vector<uint32_t> drawIndices(Distribution dist, size_t n, size_t count) {
+	std::vector<uint32_t> idx(count);
+	uint64_t x = 12345;
+	if (dist == SEQUENTIAL) {
+		for (size_t i = 0; i < count; ++i)
+			idx[i] = uint32_t(i % n);
+	}
+	else if (dist == UNIFORM) {
+		for (size_t i = 0; i < count; ++i)
+			idx[i] = uint32_t((x = hashMix(x + i)) % n);
+	}
+	else {
+		// inverse of the Zipf CDF by binary search; key i has rank i
+		std::vector<double> cdf(n);
+		double sum = 0;
+		for (size_t i = 0; i < n; ++i)
+			cdf[i] = (sum += 1.0 / std::pow(double(i + 1), 0.99));
+		for (size_t i = 0; i < count; ++i) {
+			x = hashMix(x + i);
+			double u = double(x >> 11) * 0x1.0p-53 * sum;
+			idx[i] = uint32_t(std::min(n - 1, size_t(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin())));
+		}
+	}
+	return idx;
+}
+
+// Lookup copying the value out, the one form every table offers
+template <class T, class K>
+static bool lookup(const T& t, const K& key, uint64_t& out) {
+	const uint64_t* v = t.find(key);
+	if (!v)
+		return false;
+	out = *v;
+	return true;
+}
+
+template <class K>
+static bool lookup(const ConcurrentHashTable<K, uint64_t>& t, const K& key, uint64_t& out) {
+	return t.find(key, out);
+}
+
+// Runs the operations of idx / isWrite on a filled table, split evenly
+// between threads that each put back their own erased keys
+template <class T, class K>
+static void measure(T& t, const std::vector<K>& keys, const std::vector<uint32_t>& idx,
+	const std::vector<uint8_t>& isWrite, unsigned threads, Result& r) {
+	typedef std::chrono::steady_clock Clock;
+	size_t n = keys.size();
+	std::vector<std::vector<uint32_t>> ns(threads);
+	Timer total;
+	auto work = [&](unsigned id) {
+		std::vector<uint32_t>& lat = ns[id];
+		lat.reserve(idx.size() / threads + 1);
+		uint64_t sum = 0, v = 0;
+		size_t pending = n; // erased key waiting to go back, n if none
+		Clock::time_point prev = Clock::now();
+		for (size_t i = id; i < idx.size(); i += threads) {
+			if (!isWrite[i]) {
+				if (lookup(t, keys[idx[i]], v))
+					sum += v;
+			}
+			else if (pending != n) {
+				t.insert(keys[pending], pending);
+				pending = n;
+			}
+			else if (t.erase(keys[idx[i]])) {
+				pending = idx[i];
+			}
+			Clock::time_point now = Clock::now();
+			lat.push_back(uint32_t(std::min<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - prev).count(), UINT32_MAX)));
+			prev = now;
+			if ((lat.size() & 255) == 0 && total.seconds() > TIME_BUDGET)
+				break;
+		}
+		doNotOptimize(sum);
+	};
+	if (threads == 1) {
+		work(0);
+	}
+	else {
+		std::vector<std::thread> pool;
+		for (unsigned id = 0; id < threads; ++id)
+			pool.emplace_back(work, id);
+		for (std::thread& th : pool)
+			th.join();
+	}
+	double seconds = total.seconds();
+
+	std::vector<uint32_t> all;
+	for (const std::vector<uint32_t>& lat : ns)
+		all.insert(all.end(), lat.begin(), lat.end());
+	std::sort(all.begin(), all.end());
+	auto pct = [&](double p) { return double(all[std::min(all.size() - 1, size_t(p * double(all.size())))]); };
+	r.n = n;
+	r.ops = all.size();
+	r.opsPerSec = double(all.size()) / seconds;
+	r.p50 = pct(0.5);
+	r.p90 = pct(0.9);
+	r.p99 = pct(0.99);
+	r.p999 = pct(0.999);
+}
+
+template <class K>
+static Result runBackend(const std::vector<K>& keys, const std::vector<uint32_t>& idx, const std::vector<uint8_t>& isWrite,
+	typename Table<K, uint64_t>::Backend backend) {
+	size_t n = keys.size();
+	Result r;
+	r.backend = BACKEND_NAMES[backend];
+
+	size_t before = liveBytes;
+	// bulk fill through the hash table, then one move to the backend, so
+	// the sorted array is built once instead of relaid per insert
+	Table<K, uint64_t> t(Table<K, uint64_t>::BACKEND_HASH);
+	for (size_t i = 0; i < n; ++i)
+		t.insert(keys[i], i);
+	t.setBackend(backend);
+	size_t bytes = liveBytes - before;
+	if (backend == Table<K, uint64_t>::BACKEND_AVL)
+		bytes += n * sizeof(typename AVLTable<K, uint64_t>::Node);
+	r.bytesPerEntry = double(bytes) / double(n);
+
+	measure(t, keys, idx, isWrite, 1, r);
+	return r;
+}
+
+// A table filled by n inserts, as it grows in use
+template <class T, class K>
+static Result runFilled(T& t, const char* name, const std::vector<K>& keys, const std::vector<uint32_t>& idx,
+	const std::vector<uint8_t>& isWrite, unsigned threads) {
+	Result r;
+	r.backend = name;
+	size_t before = liveBytes;
+	for (size_t i = 0; i < keys.size(); ++i)
+		t.insert(keys[i], i);
+	r.bytesPerEntry = double(liveBytes - before) / double(keys.size());
+	measure(t, keys, idx, isWrite, threads, r);
+	return r;
+}
+
+template <class K>
+static void runAll(const char* keyType, const std::vector<K>& keys, const Distribution* dists, size_t distCount,
+	std::vector<Result>& out) {
+	unsigned mixes[] = { 90, 50 };
+	for (size_t d = 0; d < distCount; ++d) {
+		std::vector<uint32_t> idx = drawIndices(dists[d], keys.size(), MAX_OPS);
+		for (unsigned read : mixes) {
+			std::vector<uint8_t> isWrite(MAX_OPS);
+			for (size_t i = 0; i < MAX_OPS; ++i)
+				isWrite[i] = hashMix(i ^ 0xABCDEF) % 100 >= read;
+			std::vector<Result> rs;
+			for (int b = Table<K, uint64_t>::BACKEND_UNSORTED; b <= Table<K, uint64_t>::BACKEND_HASH; ++b)
+				rs.push_back(runBackend(keys, idx, isWrite, typename Table<K, uint64_t>::Backend(b)));
+			{
+				HashTable<K, uint64_t> t(HashTable<K, uint64_t>::RESIZE_INCREMENTAL);
+				rs.push_back(runFilled(t, "hash incremental", keys, idx, isWrite, 1));
+			}
+			{
+				ConcurrentHashTable<K, uint64_t> t;
+				rs.push_back(runFilled(t, "concurrent", keys, idx, isWrite, 1));
+			}
+			{
+				ConcurrentHashTable<K, uint64_t> t;
+				rs.push_back(runFilled(t, "concurrent contended", keys, idx, isWrite, CONTENDED_THREADS));
+			}
+			for (Result& r : rs) {
+				r.keys = keyType;
+				r.dist = DIST_NAMES[dists[d]];
+				r.readPercent = read;
+				out.push_back(r);
+				std::fprintf(stderr, ".");
+			}
+		}
+	}
+}
+
+static void printCsv(const std::vector<Result>& results) {
+	std::printf("keys,distribution,read_percent,backend,n,ops,ops_per_sec,p50_ns,p90_ns,p99_ns,p999_ns,bytes_per_entry\n");
+	for (const Result& r : results)
+		std::printf("%s,%s,%u,%s,%zu,%zu,%.0f,%.0f,%.0f,%.0f,%.0f,%.1f\n", r.keys.c_str(), r.dist.c_str(), r.readPercent,
+			r.backend.c_str(), r.n, r.ops, r.opsPerSec, r.p50, r.p90, r.p99, r.p999, r.bytesPerEntry);
+}
+
+static void printJson(const std::vector<Result>& results) {
+	std::printf("[\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result& r = results[i];
+		std::printf("  {\"keys\": \"%s\", \"distribution\": \"%s\", \"read_percent\": %u, \"backend\": \"%s\", "
+			"\"n\": %zu, \"ops\": %zu, \"ops_per_sec\": %.0f, \"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, "
+			"\"p999_ns\": %.0f, \"bytes_per_entry\": %.1f}%s\n", r.keys.c_str(), r.dist.c_str(), r.readPercent,
+			r.backend.c_str(), r.n, r.ops, r.opsPerSec, r.p50, r.p90, r.p99, r.p999, r.bytesPerEntry,
+			i + 1 < results.size() ? "," : "");
+	}
+	std::printf("]\n");
+}
+
+int main(int argc, char** argv) {
+	size_t n = 1 << 16;
+	bool json = false;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--json") == 0)
+			json = true;
+		else
+			n = size_t(argSize(argc, argv, long(n), i));
+	}
+
+	std::vector<Result> results;
+	{
+		// sequential keys are 0 .. n - 1 visited in order
+		std::vector<uint64_t> random(n), sequential(n);
+		for (size_t i = 0; i < n; ++i) {
+			random[i] = hashMix(i);
+			sequential[i] = i;
+		}
+		Distribution spread[] = { UNIFORM, ZIPF };
+		Distribution inOrder[] = { SEQUENTIAL };
+		runAll("u64", random, spread, 2, results);
+		runAll("u64", sequential, inOrder, 1, results);
+	}
+	{
+		std::vector<std::string> strings(n);
+		for (size_t i = 0; i < n; ++i) {
+			uint64_t h = hashMix(i);
+			// a unique prefix padded to a random length
+			strings[i] = std::to_string(i) + "_";
+			strings[i].resize(std::max(strings[i].size(), size_t(4 + h % 61)), char('a' + (h >> 32) % 26));
+		}
+		Distribution spread[] = { UNIFORM, ZIPF };
+		runAll("string", strings, spread, 2, results);
+	}
+	std::fprintf(stderr, "\n");
+
+	if (json)
+		printJson(results);
+	else
+		printCsv(results);
+	return 0;
+}
@@ -0,0 +1,42 @@
+#include "List.h"
+#include "unrolled_list.h"
+#include "bench_util.h"
+#include <sstream>
+
+// Traversal-bound operations on List<T> vs UnrolledList<T, K>:
+// size, find (miss), operator== and operator<<
+
+template <class L>
+void fill(L& list, long n) {
+	auto pos = list.insert_front(0);
+	for (long i = 1; i < n; ++i)
+		pos = list.insert(static_cast<int>(i), pos);
+}
+
+template <class L>
+void runCase(const std::string& name, long n, int reps) {
+	L a, b;
+	report(name + " build", bestOf(1, [&] { fill(a, n); }), static_cast<double>(n));
+	fill(b, n);
+
+	report(name + " size", bestOf(reps, [&] { doNotOptimize(a.size()); }), static_cast<double>(n));
+	report(name + " find miss", bestOf(reps, [&] { doNotOptimize(a.find(-1)); }), static_cast<double>(n));
+	report(name + " operator==", bestOf(reps, [&] { doNotOptimize(a == b); }), static_cast<double>(n));
+	report(name + " operator<<", bestOf(reps, [&] {
+		std::ostringstream out;
+		out << a;
+		doNotOptimize(out.tellp());
+	}), static_cast<double>(n));
+}
+
+int main(int argc, char** argv) {
+	long n = argSize(argc, argv, 1000000);
+	int reps = 5;
+
+	std::printf("list of %ld ints, best of %d\n", n, reps);
+	runCase<List<int>>("List<int>", n, reps);
+	runCase<UnrolledList<int, 16>>("UnrolledList<int, 16>", n, reps);
+	runCase<UnrolledList<int, 64>>("UnrolledList<int, 64>", n, reps);
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include "unsorted_table.h"
+#include "List.h"
+#include "bench_util.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// Small unordered tables: UnsortedTable (fingerprint scan) vs a table on
+// List<pair<K, V>> with a linear find, for integer and string keys.
+// Each round inserts n keys, looks every key up (plus n misses), then
+// erases them all.
+
+template <class K, class V>
+struct ListTable {
+	typedef typename List<std::pair<K, V>>::Node Node;
+	List<std::pair<K, V>> list;
+
+	// node holding key, prev is set to its predecessor (nullptr for the head)
+	Node* find(const K& key, Node*& prev) {
+		prev = nullptr;
+		for (Node* node = list.get_first(); node != nullptr; prev = node, node = node->next)
+			if (node->data.first == key)
+				return node;
+		return nullptr;
+	}
+
+	V* find(const K& key) {
+		Node* prev;
+		Node* node = find(key, prev);
+		return node ? &node->data.second : nullptr;
+	}
+
+	bool insert(const K& key, const V& value) {
+		Node* prev;
+		if (find(key, prev))
+			return false;
+		list.insert_front(std::make_pair(key, value));
+		return true;
+	}
+
+	bool erase(const K& key) {
+		Node* prev;
+		if (!find(key, prev))
+			return false;
+		if (prev)
+			list.erase(prev);
+		else
+			list.erase_front();
+		return true;
+	}
+};
+
+template <class Table, class K>
+void runCase(const std::string& name, const std::vector<K>& hits, const std::vector<K>& misses, long rounds) {
+	Table table;
+	double n = double(hits.size()) * double(rounds);
+
+	report(name + " insert", bestOf(3, [&] {
+		for (long r = 0; r < rounds; ++r) {
+			table = Table();
+			for (size_t i = 0; i < hits.size(); ++i)
+				table.insert(hits[i], int(i));
+		}
+	}), n);
+
+	report(name + " lookup hit", bestOf(3, [&] {
+		long sum = 0;
+		for (long r = 0; r < rounds; ++r)
+			for (size_t i = 0; i < hits.size(); ++i)
+				sum += *table.find(hits[i]);
+		doNotOptimize(sum);
+	}), n);
+
+	report(name + " lookup miss", bestOf(3, [&] {
+		long found = 0;
+		for (long r = 0; r < rounds; ++r)
+			for (size_t i = 0; i < misses.size(); ++i)
+				found += table.find(misses[i]) != nullptr;
+		doNotOptimize(found);
+	}), n);
+
+	report(name + " erase", bestOf(1, [&] {
+		for (size_t i = 0; i < hits.size(); ++i)
+			table.erase(hits[i]);
+	}), double(hits.size()));
+}
+
+int main(int argc, char** argv) {
+	long maxN = argSize(argc, argv, 512);
+
+	for (long n = 8; n <= maxN; n *= 4) {
+		long rounds = 2000000 / (n * n) + 1;
+		std::vector<long> ih, im;
+		std::vector<std::string> sh, sm;
+		for (long i = 0; i < n; ++i) {
+			ih.push_back(i * 7919);
+			im.push_back(i * 7919 + 1);
+			sh.push_back("polynomial_" + std::to_string(i * 7919));
+			sm.push_back("polynomial_" + std::to_string(i * 7919 + 1));
+		}
+
+		std::printf("n = %ld, %ld rounds\n", n, rounds);
+		runCase<UnsortedTable<long, int>>("  UnsortedTable<long>", ih, im, rounds);
+		runCase<ListTable<long, int>>("  List<long> find", ih, im, rounds);
+		runCase<UnsortedTable<std::string, int>>("  UnsortedTable<string>", sh, sm, rounds);
+		runCase<ListTable<std::string, int>>("  List<string> find", sh, sm, rounds);
+	}
+	return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef __BENCH_UTIL_H__
+#define __BENCH_UTIL_H__
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Minimal timing helpers shared by the bench_* executables.
+
+// Keeps the optimizer from discarding a computed value
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+	static const void* volatile sink;
+	sink = &value;
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+class Timer {
+	std::chrono::steady_clock::time_point start;
+
+public:
+	Timer() : start(std::chrono::steady_clock::now()) {}
+
+	void reset() { start = std::chrono::steady_clock::now(); }
+
+	double seconds() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+// Best wall time of `reps` runs of fn, in seconds
+template <class F>
+double bestOf(int reps, F&& fn) {
+	double best = 1e300;
+	for (int r = 0; r < reps; ++r) {
+		Timer t;
+		fn();
+		double s = t.seconds();
+		if (s < best)
+			best = s;
+	}
+	return best;
+}
+
+inline void report(const std::string& name, double seconds, double items) {
+	std::printf("%-40s %10.3f ms %10.2f ns/item\n", name.c_str(), seconds * 1e3, seconds * 1e9 / items);
+}
+
+// Size override from the command line: bench_x [n]
+inline long argSize(int argc, char** argv, long deflt, int index = 1) {
+	return argc > index ? std::atol(argv[index]) : deflt;
+}
+
+#endif
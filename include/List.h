@@ -1,10 +1,16 @@
 ﻿#pragma once
 #include <iostream>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "pool.h"
 
 
 using namespace std;
 
-template <class T>
+// Nodes are obtained from Alloc (rebound to Node); by default they come from
+// a pooled slab allocator instead of individual new/delete.
+template <class T, class Alloc = PoolAllocator<T>>
 class List {
 public:
 	struct Node {
@@ -20,74 +26,143 @@ public:
 		}
 	};
 private:
+	using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAlloc>;
+
 	Node* first;
+	Node* last;
+	NodeAlloc alloc;
+
+	Node* create_node(const T& value, Node* next) {
+		Node* node = NodeTraits::allocate(alloc, 1);
+		try {
+			NodeTraits::construct(alloc, node, value, next);
+		}
+		catch (...) {
+			NodeTraits::deallocate(alloc, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void destroy_node(Node* node) noexcept {
+		NodeTraits::destroy(alloc, node);
+		NodeTraits::deallocate(alloc, node, 1);
+	}
+
+	void copy_from(const List& other) {
+		Node** tail = &first;
+		for (Node* ocurent = other.first; ocurent != nullptr; ocurent = ocurent->next) {
+			last = create_node(ocurent->data, nullptr);
+			*tail = last;
+			tail = &last->next;
+		}
+	}
+
+	// Merges two sorted null-terminated chains, returns the new head
+	template <class Compare>
+	static Node* merge_chains(Node* a, Node* b, Compare& comp) {
+		Node* head = nullptr;
+		Node** link = &head;
+
+		while (a != nullptr && b != nullptr) {
+			// take from b only when strictly smaller, so the merge is stable
+			if (comp(b->data, a->data)) {
+				*link = b;
+				b = b->next;
+			}
+			else {
+				*link = a;
+				a = a->next;
+			}
+			link = &(*link)->next;
+		}
+		*link = a ? a : b;
+
+		return head;
+	}
+
 public:
 
-	List() : first(nullptr) {}
-	List(int n, T deflt = T()) {
+	List() : first(nullptr), last(nullptr) {}
+	List(int n, T deflt = T()) : first(nullptr), last(nullptr) {
 		if (n == 0)
 			return;
 		if (n < 0)
 			throw "List cant have a negative size";
-		first = new Node(deflt, nullptr);
+		first = create_node(deflt, nullptr);
 		Node* current = first;
 
 		for (int i = 1; i < n; i++) {
-			Node* tmp = new Node(deflt, nullptr);
+			Node* tmp = create_node(deflt, nullptr);
 			current->next = tmp;
 			current = current->next;
 		}
+		last = current;
 	}
 
 	~List() {
 		clear();
 	}
 
-	List(const List& other) {
-		if (other.first == nullptr)
-			throw "size of list = zero";
-
-		first = new Node(other.first->data, nullptr);
-		Node* current = first;
-		Node* ocurent = other.first;
-
-		while (ocurent->next) {
-			current->next = new Node(ocurent->data, nullptr);
-			current = current->next;
-			ocurent = ocurent->next;
+	List(const List& other) : first(nullptr), last(nullptr), alloc(NodeTraits::select_on_container_copy_construction(other.alloc)) {
+		try {
+			copy_from(other);
+		}
+		catch (...) {
+			clear();
+			throw;
 		}
 	}
 
-	List<T>& operator=(const List<T>& other) noexcept {
+	List(List&& other) noexcept : first(other.first), last(other.last), alloc(std::move(other.alloc)) {
+		other.first = nullptr;
+		other.last = nullptr;
+	}
+
+	List& operator=(const List& other) {
 		if (this == &other)
 			return *this;
 
 		clear();
+		copy_from(other);
 
-		if (other.first == nullptr)
-			return *this;
+		return *this;
+	}
 
-		first = new Node(other.first->data, nullptr);
-		Node* current = first;
-		Node* ocurent = other.first->next;
+	// Nodes are taken over, so the allocators of both lists must be interchangeable
+	List& operator=(List&& other) noexcept {
+		if (this == &other)
+			return *this;
 
-		while (ocurent != nullptr) {
-			current->next = new Node(ocurent->data, nullptr);
-			current = current->next;
-			ocurent = ocurent->next;
-		}
+		clear();
+		first = other.first;
+		last = other.last;
+		other.first = nullptr;
+		other.last = nullptr;
 
 		return *this;
 	}
 
+	void swap(List& other) noexcept {
+		std::swap(first, other.first);
+		std::swap(last, other.last);
+		std::swap(alloc, other.alloc);
+	}
+
+	friend void swap(List& a, List& b) noexcept {
+		a.swap(b);
+	}
+
 	void clear() {
 		Node* current = first;
 		while (current != nullptr) {
 			Node* next = current->next;
-			delete current;
+			destroy_node(current);
 			current = next;
 		}
 		first = nullptr;
+		last = nullptr;
 	}
 
 	void print() {
@@ -121,9 +196,19 @@ public:
 			current = current->next;
 		}
 		cout << endl;
+
+		// put the links back
+		current = prev;
+		prev = nullptr;
+		while (current != nullptr) {
+			next = current->next;
+			current->next = prev;
+			prev = current;
+			current = next;
+		}
 	}
 
-	bool operator==(const List<T>& other) const noexcept {
+	bool operator==(const List& other) const noexcept {
 		Node* current1 = first;
 		Node* current2 = other.first;
 
@@ -136,17 +221,8 @@ public:
 		return (current1 == nullptr && current2 == nullptr);
 	}
 
-	bool operator!=(const List<T>& other) const noexcept {
-		Node* current1 = first;
-		Node* current2 = other.first;
-
-		while (current1 != nullptr && current2 != nullptr) {
-			if (current1->data == current2->data)
-				return false;
-			current1 = current1->next;
-			current2 = current2->next;
-		}
-		return (current1 != nullptr || current2 != nullptr);
+	bool operator!=(const List& other) const noexcept {
+		return !(*this == other);
 	}
 
 	T& operator[](int index) {
@@ -172,7 +248,7 @@ public:
 		return count;
 	}
 
-	inline List<T>::Node* get_index(int index) {
+	inline Node* get_index(int index) {
 		if (index < 0 || index >= size())
 			throw out_of_range("Index out of range");
 
@@ -185,52 +261,139 @@ public:
 		return current;
 	}
 
-	inline List<T>::Node* insert(T value, Node* prev) {
-		Node* tmp = new Node;
-
-		tmp->next = prev; //от предыдущего элемента получили ссылку на след
-		tmp->data = value;
-		prev->next = tmp;
+	inline Node* insert(T value, Node* prev) {
+		//от предыдущего элемента получили ссылку на след
+		prev->next = create_node(value, prev->next);
+		if (prev == last)
+			last = prev->next;
 
-		return tmp;
-		//либо так
-		//return prev->next = new temp Node(prev->next, value);
+		return prev->next;
 	}
 
 
-	inline List<T>::Node* insert_front(T value) {
-		Node* first_first = new Node;
-
-		first_first->next = first;
-		first_first->data = value;
-		first = first_first;
+	inline Node* insert_front(T value) {
+		first = create_node(value, first);
+		if (last == nullptr)
+			last = first;
 
 		return first;
 	}
 
+	inline Node* insert_back(T value) {
+		Node* tmp = create_node(value, nullptr);
+		if (last == nullptr)
+			first = tmp;
+		else
+			last->next = tmp;
+		last = tmp;
+
+		return last;
+	}
+
 
-	inline List<T>::Node* erase(Node* prev)
+	inline Node* erase(Node* prev)
 	{
 		Node* tmp = prev->next;
 
-		if (!(prev->next)) throw;
+		if (!(prev->next)) throw out_of_range("No element after the given node");
 
 		prev->next = tmp->next;
-		delete tmp;
+		if (tmp == last)
+			last = prev;
+		destroy_node(tmp);
 
 		return prev->next;
 	}
 
-	inline List<T>::Node* erase_front()
+	inline Node* erase_front()
 	{
 		Node* tmp = first;
 		first = tmp->next;
-		delete tmp;
+		if (first == nullptr)
+			last = nullptr;
+		destroy_node(tmp);
 
 		return first;
 	}
 
-	inline List<T>::Node* find(T value) const {
+	// Moves all nodes of other after prev (to the front if prev is nullptr)
+	// in O(1); other is left empty
+	void splice(Node* prev, List& other) noexcept {
+		if (this == &other || other.first == nullptr)
+			return;
+
+		Node* next = prev ? prev->next : first;
+		other.last->next = next;
+		if (prev)
+			prev->next = other.first;
+		else
+			first = other.first;
+		if (next == nullptr)
+			last = other.last;
+
+		other.first = nullptr;
+		other.last = nullptr;
+	}
+
+	// Merges sorted other into this sorted list without allocation;
+	// other is left empty. Equal elements of this list come first.
+	template <class Compare = std::less<T>>
+	void merge(List& other, Compare comp = Compare()) {
+		if (this == &other || other.first == nullptr)
+			return;
+		if (first == nullptr) {
+			splice(nullptr, other);
+			return;
+		}
+
+		first = merge_chains(first, other.first, comp);
+		// whichever list ran out first had its last node linked to the other
+		if (last->next != nullptr)
+			last = other.last;
+		other.first = nullptr;
+		other.last = nullptr;
+	}
+
+	// Stable merge sort, O(n log n) time and O(1) extra memory.
+	// Nodes are fed into bins holding sorted runs of 2^i nodes, so most merges
+	// work on recently touched nodes instead of sweeping the whole list.
+	template <class Compare = std::less<T>>
+	void sort(Compare comp = Compare()) {
+		if (first == nullptr || first->next == nullptr)
+			return;
+
+		Node* bins[64] = {};
+		int used = 0;
+		Node* rest = first;
+
+		while (rest != nullptr) {
+			Node* carry = rest;
+			rest = rest->next;
+			carry->next = nullptr;
+
+			int i = 0;
+			for (; i < used && bins[i] != nullptr; ++i) {
+				carry = merge_chains(bins[i], carry, comp);
+				bins[i] = nullptr;
+			}
+			bins[i] = carry;
+			if (i == used)
+				used++;
+		}
+
+		// higher bins hold earlier elements
+		Node* result = nullptr;
+		for (int i = 0; i < used; ++i)
+			if (bins[i] != nullptr)
+				result = result ? merge_chains(bins[i], result, comp) : bins[i];
+
+		first = result;
+		last = first;
+		while (last->next != nullptr)
+			last = last->next;
+	}
+
+	inline Node* find(T value) const {
 		Node* current = first;
 
 		while (current != nullptr) {
@@ -243,11 +406,21 @@ public:
 		return nullptr;
 	}
 
-	inline List<T>::Node* get_first() noexcept
+	inline Node* get_first() noexcept
 	{
 		return first;
 	}
 
+	inline Node* get_last() noexcept
+	{
+		return last;
+	}
+
+	bool empty() const noexcept
+	{
+		return first == nullptr;
+	}
+
 	friend istream& operator>>(istream& istr, List& other)
 	{
 		Node* current = other.first;
@@ -2,14 +2,29 @@
 #define __ARTANS_H__
 
 #include "stack.h"
+#include "polynomial.h"
+#include "expression_program.h"
+#include <cctype>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <cmath>  
+#include <memory>
 #include <stdexcept>  
 
 class ArithmeticTranslator {
+    // identifiers of the compiled programs, shared by all of them
+    std::shared_ptr<StringInterner> identifiers = std::make_shared<StringInterner>();
+
 public:
+    const std::shared_ptr<StringInterner>& interner() const { return identifiers; }
+
+    // Makes later programs name their variables in names, e.g. to share
+    // one interner between several translators
+    void setInterner(std::shared_ptr<StringInterner> names) {
+        identifiers = std::move(names);
+    }
+
     std::string ToPostFix(const std::string& infix) {
         std::string output = "";
         Stack<char> operators;
@@ -117,6 +132,182 @@ public:
         return Calculate(postfix);
     }
 
+    // Compiles an infix expression in x, y, z straight into a canonical sparse
+    // polynomial. Operators are applied to polynomial operands as soon as the
+    // shunting-yard pops them, so like terms are collected during parsing and
+    // no postfix string or token vector is built. Coef selects the coefficient
+    // ring, e.g. ToPolynomial<ModP61>(infix) computes modulo 2^61 - 1.
+    template <class Coef = double>
+    BasicPolynomial<Coef> ToPolynomial(const std::string& infix) {
+        Stack<char> operators;
+        Stack<BasicPolynomial<Coef>> operands;
+        bool expectOperand = true;
+        size_t i = 0;
+
+        while (i < infix.size()) {
+            char c = infix[i];
+
+            if (isspace(static_cast<unsigned char>(c))) {
+                ++i;
+            }
+            else if (isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                if (!expectOperand) {
+                    throw std::invalid_argument("Missing operator before number");
+                }
+                operands.push(BasicPolynomial<Coef>(CoefficientTraits<Coef>::fromNumber(readNumber(infix, i))));
+                expectOperand = false;
+            }
+            else if (isalpha(static_cast<unsigned char>(c))) {
+                if (!expectOperand) {
+                    throw std::invalid_argument("Missing operator before variable");
+                }
+                operands.push(readVariable<Coef>(infix, i));
+                expectOperand = false;
+            }
+            else if (c == '(') {
+                if (!expectOperand) {
+                    throw std::invalid_argument("Missing operator before '('");
+                }
+                operators.push('(');
+                ++i;
+            }
+            else if (c == ')') {
+                while (!operators.empty() && operators.top() != '(') {
+                    applyPolynomialOperator(operands, operators.pop());
+                }
+                if (operators.empty()) {
+                    throw std::invalid_argument("Mismatched parentheses: no opening bracket for ')'");
+                }
+                operators.pop();
+                expectOperand = false;
+                ++i;
+            }
+            else if (c == '-' && expectOperand) {
+                operators.push('~');
+                ++i;
+            }
+            else if (isOperator(c) || c == '^') {
+                if (expectOperand) {
+                    throw std::invalid_argument(std::string("Missing operand before '") + c + "'");
+                }
+                // '^' is right-associative, the others are left-associative
+                while (!operators.empty() && operators.top() != '(' &&
+                    (c == '^' ? precedence(operators.top()) > precedence(c)
+                              : precedence(operators.top()) >= precedence(c))) {
+                    applyPolynomialOperator(operands, operators.pop());
+                }
+                operators.push(c);
+                expectOperand = true;
+                ++i;
+            }
+            else {
+                throw std::invalid_argument(std::string("Invalid token: ") + c);
+            }
+        }
+
+        while (!operators.empty()) {
+            if (operators.top() == '(') {
+                throw std::invalid_argument("Mismatched parentheses: no closing bracket for '('");
+            }
+            applyPolynomialOperator(operands, operators.pop());
+        }
+
+        if (operands.sizes() != 1) {
+            throw std::invalid_argument("Invalid expression");
+        }
+
+        return operands.pop();
+    }
+
+    // Compiles an infix expression into bytecode for a stack machine, in the
+    // same single pass as ToPolynomial: operators are emitted as the
+    // shunting-yard pops them. Any identifier (a letter, then letters and
+    // digits) is a variable and gets a slot of the program; identifiers are
+    // interned, so every program of this translator shares one copy of each.
+    ExpressionProgram ToProgram(const std::string& infix) {
+        Stack<char> operators;
+        ExpressionProgram program(identifiers);
+        bool expectOperand = true;
+        size_t i = 0;
+
+        while (i < infix.size()) {
+            char c = infix[i];
+
+            if (isspace(static_cast<unsigned char>(c))) {
+                ++i;
+            }
+            else if (isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                if (!expectOperand) {
+                    throw std::invalid_argument("Missing operator before number");
+                }
+                program.pushConstant(readNumber(infix, i));
+                expectOperand = false;
+            }
+            else if (isalpha(static_cast<unsigned char>(c))) {
+                if (!expectOperand) {
+                    throw std::invalid_argument("Missing operator before variable");
+                }
+                size_t start = i;
+                while (i < infix.size() && isalnum(static_cast<unsigned char>(infix[i]))) {
+                    ++i;
+                }
+                program.pushVariable(std::string_view(infix).substr(start, i - start));
+                expectOperand = false;
+            }
+            else if (c == '(') {
+                if (!expectOperand) {
+                    throw std::invalid_argument("Missing operator before '('");
+                }
+                operators.push('(');
+                ++i;
+            }
+            else if (c == ')') {
+                while (!operators.empty() && operators.top() != '(') {
+                    program.emit(programOp(operators.pop()));
+                }
+                if (operators.empty()) {
+                    throw std::invalid_argument("Mismatched parentheses: no opening bracket for ')'");
+                }
+                operators.pop();
+                expectOperand = false;
+                ++i;
+            }
+            else if (c == '-' && expectOperand) {
+                operators.push('~');
+                ++i;
+            }
+            else if (isOperator(c) || c == '^') {
+                if (expectOperand) {
+                    throw std::invalid_argument(std::string("Missing operand before '") + c + "'");
+                }
+                while (!operators.empty() && operators.top() != '(' &&
+                    (c == '^' ? precedence(operators.top()) > precedence(c)
+                              : precedence(operators.top()) >= precedence(c))) {
+                    program.emit(programOp(operators.pop()));
+                }
+                operators.push(c);
+                expectOperand = true;
+                ++i;
+            }
+            else {
+                throw std::invalid_argument(std::string("Invalid token: ") + c);
+            }
+        }
+
+        while (!operators.empty()) {
+            if (operators.top() == '(') {
+                throw std::invalid_argument("Mismatched parentheses: no closing bracket for '('");
+            }
+            program.emit(programOp(operators.pop()));
+        }
+
+        if (!program.isComplete()) {
+            throw std::invalid_argument("Invalid expression");
+        }
+
+        return program;
+    }
+
 private:
     bool isNumber(const std::string& token) {
         if (token.empty()) return false;
@@ -163,6 +354,10 @@ private:
         return token == "+" || token == "-" || token == "*" || token == "/";
     }
 
+    bool isOperator(char c) {
+        return c == '+' || c == '-' || c == '*' || c == '/';
+    }
+
     int precedence(char op) {
         if (op == '^') return 4;
         if (op == '~') return 3;
@@ -181,6 +376,95 @@ private:
         }
     }
 
+    static ProgramOp programOp(char op) {
+        switch (op) {
+        case '~': return OP_NEG;
+        case '+': return OP_ADD;
+        case '-': return OP_SUB;
+        case '*': return OP_MUL;
+        case '/': return OP_DIV;
+        default: return OP_POW;
+        }
+    }
+
+    // Reads a number starting at str[i] in place, advancing i past it
+    double readNumber(const std::string& str, size_t& i) {
+        double result = 0;
+        for (; i < str.size() && isdigit(static_cast<unsigned char>(str[i])); ++i) {
+            result = result * 10 + (str[i] - '0');
+        }
+
+        if (i < str.size() && str[i] == '.') {
+            ++i;
+            for (double place = 0.1; i < str.size() && isdigit(static_cast<unsigned char>(str[i])); ++i, place *= 0.1) {
+                result += (str[i] - '0') * place;
+            }
+        }
+
+        if (i < str.size() && str[i] == '.') {
+            throw std::invalid_argument("Invalid number: more than one '.'");
+        }
+        return result;
+    }
+
+    template <class Coef>
+    BasicPolynomial<Coef> readVariable(const std::string& str, size_t& i) {
+        size_t start = i;
+        while (i < str.size() && isalnum(static_cast<unsigned char>(str[i]))) {
+            ++i;
+        }
+        if (i - start == 1) {
+            switch (str[start]) {
+            case 'x': return BasicPolynomial<Coef>::monomial(Coef(1), 1, 0, 0);
+            case 'y': return BasicPolynomial<Coef>::monomial(Coef(1), 0, 1, 0);
+            case 'z': return BasicPolynomial<Coef>::monomial(Coef(1), 0, 0, 1);
+            }
+        }
+        throw std::invalid_argument("Unknown variable: " + str.substr(start, i - start));
+    }
+
+    template <class Coef>
+    void applyPolynomialOperator(Stack<BasicPolynomial<Coef>>& operands, char op) {
+        if (operands.empty()) {
+            throw std::invalid_argument("Invalid expression: missing operand");
+        }
+        BasicPolynomial<Coef> b = operands.pop();
+
+        if (op == '~') {
+            operands.push(-b);
+            return;
+        }
+        if (operands.empty()) {
+            throw std::invalid_argument("Invalid expression: missing operand");
+        }
+        BasicPolynomial<Coef> a = operands.pop();
+
+        switch (op) {
+        case '+': operands.push(a + b); break;
+        case '-': operands.push(a - b); break;
+        case '*': operands.push(a * b); break;
+        case '/':
+            if (!b.isConstant()) {
+                throw std::invalid_argument("Division by a non-constant polynomial");
+            }
+            operands.push(a / b.coefficient(0, 0, 0));
+            break;
+        case '^': {
+            Coef e = b.coefficient(0, 0, 0);
+            if (a.isConstant() && b.isConstant()) {
+                operands.push(BasicPolynomial<Coef>(CoefficientTraits<Coef>::power(a.coefficient(0, 0, 0), e)));
+                break;
+            }
+            unsigned n = 0;
+            if (!b.isConstant() || !CoefficientTraits<Coef>::toExponent(e, Monomial::MAX_EXP, n)) {
+                throw std::invalid_argument("Exponent must be a non-negative integer constant");
+            }
+            operands.push(a.pow(n));
+            break;
+        }
+        }
+    }
+
     std::vector<std::string> StringAnalyze(const std::string& str) {
         std::vector<std::string> tokens;
         std::string current = "";
@@ -0,0 +1,481 @@
+#ifndef __AVL_TABLE_H__
+#define __AVL_TABLE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "pool.h"
+
+// Ordered table on an AVL tree. Nodes come from Alloc (rebound to Node), by
+// default the pooled slab allocator, so nodes created together share cache
+// lines. Nodes keep a parent pointer: iteration, range scans and the
+// rebalancing walk back up after insert and erase need no recursion and no
+// stack. Nodes also count their subtree, for O(log n) select and rank.
+// Keys only need operator<.
+template <class K, class V, class Alloc = PoolAllocator<std::pair<const K, V>>>
+class AVLTable {
+public:
+	// What iterators show of a node: as in std::map, the value can be
+	// changed in place but the key, which places the node, can't
+	struct Entry {
+		const K key;
+		V value;
+	};
+
+	struct Node : Entry {
+		Node* left;
+		Node* right;
+		Node* parent;
+		int height;
+		size_t size; // nodes in the subtree rooted here
+
+		Node(const K& k, const V& v, Node* p) : Entry{ k, v }, left(nullptr), right(nullptr), parent(p), height(1), size(1) {}
+	};
+
+	// Forward iterator over nodes in key order; *it is the node's entry
+	template <class N, class E>
+	class BasicIterator {
+		N* node;
+
+	public:
+		explicit BasicIterator(N* n = nullptr) : node(n) {}
+
+		E& operator*() const { return *node; }
+		E* operator->() const { return node; }
+
+		BasicIterator& operator++() {
+			node = successor(node);
+			return *this;
+		}
+
+		bool operator==(const BasicIterator& other) const { return node == other.node; }
+		bool operator!=(const BasicIterator& other) const { return node != other.node; }
+	};
+
+	typedef BasicIterator<Node, Entry> Iterator;
+	typedef BasicIterator<const Node, const Entry> ConstIterator;
+
+private:
+	using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+	Node* root;
+	size_t count;
+	NodeAlloc alloc;
+
+	Node* create_node(const K& key, const V& value, Node* parent) {
+		Node* node = NodeTraits::allocate(alloc, 1);
+		try {
+			NodeTraits::construct(alloc, node, key, value, parent);
+		}
+		catch (...) {
+			NodeTraits::deallocate(alloc, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void destroy_node(Node* node) noexcept {
+		NodeTraits::destroy(alloc, node);
+		NodeTraits::deallocate(alloc, node, 1);
+	}
+
+	// Post-order release by walking parent links
+	void destroy_tree(Node* node) noexcept {
+		while (node) {
+			if (node->left)
+				node = node->left;
+			else if (node->right)
+				node = node->right;
+			else {
+				Node* parent = node->parent;
+				if (parent) {
+					if (parent->left == node)
+						parent->left = nullptr;
+					else
+						parent->right = nullptr;
+				}
+				destroy_node(node);
+				node = parent;
+			}
+		}
+	}
+
+	Node* copy_tree(const Node* src, Node* parent) {
+		if (!src)
+			return nullptr;
+		Node* node = create_node(src->key, src->value, parent);
+		node->height = src->height;
+		node->size = src->size;
+		try {
+			node->left = copy_tree(src->left, node);
+			node->right = copy_tree(src->right, node);
+		}
+		catch (...) {
+			// detached, so destroy_tree stops at node instead of climbing
+			// into the ancestors that the outer frames free
+			node->parent = nullptr;
+			destroy_tree(node);
+			throw;
+		}
+		return node;
+	}
+
+	// Perfectly balanced subtree over sorted [lo, hi), created in key order
+	Node* build(std::vector<std::pair<K, V>>& items, size_t lo, size_t hi, Node* parent) {
+		if (lo == hi)
+			return nullptr;
+		size_t mid = lo + (hi - lo) / 2;
+		Node* left = build(items, lo, mid, nullptr);
+		Node* node;
+		try {
+			node = create_node(items[mid].first, items[mid].second, nullptr);
+		}
+		catch (...) {
+			destroy_tree(left);
+			throw;
+		}
+		node->left = left;
+		if (left)
+			left->parent = node;
+		try {
+			node->right = build(items, mid + 1, hi, node);
+		}
+		catch (...) {
+			destroy_tree(node);
+			throw;
+		}
+		node->parent = parent;
+		update(node);
+		return node;
+	}
+
+	static int height(const Node* n) { return n ? n->height : 0; }
+	static size_t sizeOf(const Node* n) { return n ? n->size : 0; }
+
+	static void update(Node* n) {
+		n->height = 1 + std::max(height(n->left), height(n->right));
+		n->size = 1 + sizeOf(n->left) + sizeOf(n->right);
+	}
+
+	template <class N>
+	static N* leftmost(N* n) {
+		if (n)
+			while (n->left)
+				n = n->left;
+		return n;
+	}
+
+	template <class N>
+	static N* successor(N* n) {
+		if (n->right)
+			return leftmost(n->right);
+		while (n->parent && n->parent->right == n)
+			n = n->parent;
+		return n->parent;
+	}
+
+	void replaceChild(Node* parent, Node* old, Node* node) {
+		if (!parent)
+			root = node;
+		else if (parent->left == old)
+			parent->left = node;
+		else
+			parent->right = node;
+	}
+
+	// x's right child takes its place
+	Node* rotateLeft(Node* x) {
+		Node* y = x->right;
+		x->right = y->left;
+		if (y->left)
+			y->left->parent = x;
+		y->parent = x->parent;
+		replaceChild(x->parent, x, y);
+		y->left = x;
+		x->parent = y;
+		update(x);
+		update(y);
+		return y;
+	}
+
+	// x's left child takes its place
+	Node* rotateRight(Node* x) {
+		Node* y = x->left;
+		x->left = y->right;
+		if (y->right)
+			y->right->parent = x;
+		y->parent = x->parent;
+		replaceChild(x->parent, x, y);
+		y->right = x;
+		x->parent = y;
+		update(x);
+		update(y);
+		return y;
+	}
+
+	// Restores the balance of n (children already balanced), returns the
+	// root of the subtree that took n's place
+	Node* rebalance(Node* n) {
+		int balance = height(n->left) - height(n->right);
+		if (balance > 1) {
+			if (height(n->left->left) < height(n->left->right))
+				rotateLeft(n->left);
+			return rotateRight(n);
+		}
+		if (balance < -1) {
+			if (height(n->right->right) < height(n->right->left))
+				rotateRight(n->right);
+			return rotateLeft(n);
+		}
+		return n;
+	}
+
+	// Walks up from p after its subtree changed, stopping once a subtree
+	// ends up as high as it was before
+	void retrace(Node* p) {
+		while (p) {
+			int old = p->height;
+			update(p);
+			Node* top = rebalance(p);
+			if (top->height == old)
+				break;
+			p = top->parent;
+		}
+	}
+
+	Node* findNode(const K& key) const {
+		Node* n = root;
+		while (n) {
+			if (key < n->key)
+				n = n->left;
+			else if (n->key < key)
+				n = n->right;
+			else
+				return n;
+		}
+		return nullptr;
+	}
+
+	// Node with k smaller keys, null if k >= size()
+	Node* selectNode(size_t k) const {
+		Node* n = root;
+		while (n) {
+			size_t left = sizeOf(n->left);
+			if (k < left)
+				n = n->left;
+			else if (k == left)
+				return n;
+			else {
+				k -= left + 1;
+				n = n->right;
+			}
+		}
+		return nullptr;
+	}
+
+	// First node with key not less than the given one
+	Node* lowerNode(const K& key) const {
+		Node* n = root;
+		Node* res = nullptr;
+		while (n) {
+			if (n->key < key)
+				n = n->right;
+			else {
+				res = n;
+				n = n->left;
+			}
+		}
+		return res;
+	}
+
+public:
+	AVLTable() : root(nullptr), count(0) {}
+
+	// O(n) build from pairs sorted by strictly increasing key
+	explicit AVLTable(std::vector<std::pair<K, V>> sorted) : root(nullptr), count(0) {
+		for (size_t i = 1; i < sorted.size(); ++i)
+			if (!(sorted[i - 1].first < sorted[i].first))
+				throw std::invalid_argument("Keys must be sorted and unique");
+		root = build(sorted, 0, sorted.size(), nullptr);
+		count = sorted.size();
+	}
+
+	AVLTable(const AVLTable& other) : root(nullptr), count(0), alloc(other.alloc) {
+		root = copy_tree(other.root, nullptr);
+		count = other.count;
+	}
+
+	AVLTable(AVLTable&& other) noexcept : root(other.root), count(other.count), alloc(std::move(other.alloc)) {
+		other.root = nullptr;
+		other.count = 0;
+	}
+
+	~AVLTable() {
+		destroy_tree(root);
+	}
+
+	AVLTable& operator=(const AVLTable& other) {
+		if (this != &other) {
+			AVLTable copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	AVLTable& operator=(AVLTable&& other) noexcept {
+		if (this != &other) {
+			clear();
+			swap(other);
+		}
+		return *this;
+	}
+
+	void swap(AVLTable& other) noexcept {
+		std::swap(root, other.root);
+		std::swap(count, other.count);
+		std::swap(alloc, other.alloc);
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	// Height of the tree, 0 when empty
+	int height() const { return height(root); }
+
+	void clear() {
+		destroy_tree(root);
+		root = nullptr;
+		count = 0;
+	}
+
+	V* find(const K& key) {
+		Node* n = findNode(key);
+		return n ? &n->value : nullptr;
+	}
+
+	const V* find(const K& key) const {
+		Node* n = findNode(key);
+		return n ? &n->value : nullptr;
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		Node* parent = nullptr;
+		Node** link = &root;
+		while (*link) {
+			parent = *link;
+			if (key < parent->key)
+				link = &parent->left;
+			else if (parent->key < key)
+				link = &parent->right;
+			else
+				return false;
+		}
+		*link = create_node(key, value, parent);
+		++count;
+		// retrace may stop early, but every ancestor gained a node
+		for (Node* p = parent; p; p = p->parent)
+			++p->size;
+		retrace(parent);
+		return true;
+	}
+
+	// Invalidates iterators to the erased node only
+	bool erase(const K& key) {
+		Node* n = findNode(key);
+		if (!n)
+			return false;
+
+		// lowest node whose subtree changed
+		Node* parent;
+		if (n->left && n->right) {
+			// n's successor (which has no left child) is unlinked and
+			// takes n's place, so entries never move between nodes
+			Node* s = leftmost(n->right);
+			if (s->parent == n) {
+				parent = s;
+			}
+			else {
+				parent = s->parent;
+				parent->left = s->right;
+				if (s->right)
+					s->right->parent = parent;
+				s->right = n->right;
+				s->right->parent = s;
+			}
+			s->left = n->left;
+			s->left->parent = s;
+			s->parent = n->parent;
+			replaceChild(n->parent, n, s);
+		}
+		else {
+			Node* child = n->left ? n->left : n->right;
+			parent = n->parent;
+			if (child)
+				child->parent = parent;
+			replaceChild(parent, n, child);
+		}
+		destroy_node(n);
+		--count;
+
+		// erase can shorten the tree at several levels, so walk to the root
+		for (Node* p = parent; p;) {
+			update(p);
+			p = rebalance(p)->parent;
+		}
+		return true;
+	}
+
+	Iterator begin() { return Iterator(leftmost(root)); }
+	Iterator end() { return Iterator(); }
+	ConstIterator begin() const { return ConstIterator(leftmost(root)); }
+	ConstIterator end() const { return ConstIterator(); }
+
+	// First entry whose key is not less than key
+	Iterator lower_bound(const K& key) { return Iterator(lowerNode(key)); }
+	ConstIterator lower_bound(const K& key) const { return ConstIterator(lowerNode(key)); }
+
+	// Entry with k smaller keys (k counts from 0), end() if k >= size()
+	Iterator select(size_t k) { return Iterator(selectNode(k)); }
+	ConstIterator select(size_t k) const { return ConstIterator(selectNode(k)); }
+
+	// Number of entries whose key is less than key
+	size_t rank(const K& key) const {
+		size_t r = 0;
+		for (const Node* n = root; n;) {
+			if (n->key < key) {
+				r += sizeOf(n->left) + 1;
+				n = n->right;
+			}
+			else
+				n = n->left;
+		}
+		return r;
+	}
+
+	// f(key, value) for every entry with lo <= key < hi, in key order
+	template <class F>
+	void range(const K& lo, const K& hi, F f) const {
+		for (const Node* n = lowerNode(lo); n && n->key < hi; n = successor(n))
+			f(n->key, n->value);
+	}
+
+	// f(key, value) for every entry in key order
+	template <class F>
+	void for_each(F f) const {
+		for (const Node* n = leftmost(root); n; n = successor(n))
+			f(n->key, n->value);
+	}
+
+	template <class F>
+	void for_each(F f) {
+		for (Node* n = leftmost(root); n; n = successor(n))
+			f(static_cast<const K&>(n->key), n->value);
+	}
+};
+
+#endif
@@ -0,0 +1,475 @@
+#ifndef __BTREE_TABLE_H__
+#define __BTREE_TABLE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Ordered table on a B+ tree. A node fills about NodeBytes (default 16
+// cache lines), so one node holds 64 uint64 entries and a lookup in a
+// million keys touches 4 nodes instead of the ~20 of a binary tree; within
+// a node the search is binary and stays on a few adjacent lines. Entries live
+// in the leaves, which are chained in key order for range scans; inner
+// nodes hold separator keys only. Every node except the root stays at
+// least half full: inserts split full nodes, erases borrow from or merge
+// with a sibling.
+// Keys need operator<, and K and V must be default-constructible as nodes
+// hold them in fixed arrays.
+template <class K, class V, size_t NodeBytes = 1024>
+class BTreeTable {
+	static constexpr size_t LEAF_CAP = std::max<size_t>(4, NodeBytes / (sizeof(K) + sizeof(V)));
+	static constexpr size_t INNER_CAP = std::max<size_t>(4, NodeBytes / (sizeof(K) + sizeof(void*)));
+	static constexpr size_t LEAF_MIN = LEAF_CAP / 2;
+	static constexpr size_t INNER_MIN = INNER_CAP / 2;
+	static constexpr int MAX_DEPTH = 64;
+
+	struct Node {
+		uint32_t count; // entries of a leaf, keys of an inner node
+		bool leaf;
+
+		explicit Node(bool isLeaf) : count(0), leaf(isLeaf) {}
+	};
+
+	struct Leaf : Node {
+		K keys[LEAF_CAP];
+		V vals[LEAF_CAP];
+		Leaf* next;
+
+		Leaf() : Node(true), next(nullptr) {}
+	};
+
+	// child[i] holds the keys below keys[i], child[i + 1] the rest
+	struct Inner : Node {
+		K keys[INNER_CAP];
+		Node* child[INNER_CAP + 1];
+
+		Inner() : Node(false) {}
+	};
+
+	Node* root; // null until the first insert, so that default-constructed,
+	            // cleared and moved-from tables allocate nothing
+	size_t count;
+	int depth; // inner levels above the leaves
+
+	static Leaf* asLeaf(Node* n) { return static_cast<Leaf*>(n); }
+	static Inner* asInner(Node* n) { return static_cast<Inner*>(n); }
+	static const Leaf* asLeaf(const Node* n) { return static_cast<const Leaf*>(n); }
+	static const Inner* asInner(const Node* n) { return static_cast<const Inner*>(n); }
+
+	// Child index to descend into for key
+	static size_t childIndex(const Inner* n, const K& key) {
+		return size_t(std::upper_bound(n->keys, n->keys + n->count, key) - n->keys);
+	}
+
+	static size_t leafIndex(const Leaf* n, const K& key) {
+		return size_t(std::lower_bound(n->keys, n->keys + n->count, key) - n->keys);
+	}
+
+	static void destroy(Node* n) noexcept {
+		if (!n->leaf) {
+			Inner* in = asInner(n);
+			for (size_t i = 0; i <= in->count; ++i)
+				destroy(in->child[i]);
+			delete in;
+		}
+		else
+			delete asLeaf(n);
+	}
+
+	// Copies the subtree; prev is the last leaf copied so far, for the chain
+	static Node* clone(const Node* src, Leaf*& prev) {
+		if (src->leaf) {
+			Leaf* n = new Leaf(*asLeaf(src));
+			n->next = nullptr;
+			if (prev)
+				prev->next = n;
+			prev = n;
+			return n;
+		}
+		const Inner* s = asInner(src);
+		Inner* n = new Inner();
+		n->count = s->count;
+		std::copy(s->keys, s->keys + s->count, n->keys);
+		size_t i = 0;
+		try {
+			for (; i <= s->count; ++i)
+				n->child[i] = clone(s->child[i], prev);
+		}
+		catch (...) {
+			n->count = uint32_t(i) - 1;
+			if (i > 0)
+				destroy(n);
+			else
+				delete n;
+			throw;
+		}
+		return n;
+	}
+
+	// Leaf where key belongs, null while the table has no root
+	Leaf* findLeaf(const K& key) const {
+		Node* n = root;
+		if (!n)
+			return nullptr;
+		while (!n->leaf)
+			n = asInner(n)->child[childIndex(asInner(n), key)];
+		return asLeaf(n);
+	}
+
+	Leaf* firstLeaf() const {
+		Node* n = root;
+		if (!n)
+			return nullptr;
+		while (!n->leaf)
+			n = asInner(n)->child[0];
+		return asLeaf(n);
+	}
+
+	// Puts key and child right of child[pos] into a non-full inner node
+	static void innerInsert(Inner* n, size_t pos, const K& key, Node* right) {
+		std::move_backward(n->keys + pos, n->keys + n->count, n->keys + n->count + 1);
+		std::move_backward(n->child + pos + 1, n->child + n->count + 1, n->child + n->count + 2);
+		n->keys[pos] = key;
+		n->child[pos + 1] = right;
+		++n->count;
+	}
+
+	// Adds separator key and node right after child[pos[level]] of
+	// path[level], splitting full nodes up to the root
+	void insertUp(Inner** path, size_t* pos, int level, K key, Node* right) {
+		while (level >= 0) {
+			Inner* n = path[level];
+			size_t p = pos[level];
+			if (n->count < INNER_CAP) {
+				innerInsert(n, p, key, right);
+				return;
+			}
+			// lay out the INNER_CAP + 1 keys in order, the middle one moves
+			// up and the keys right of it go to a new node
+			K keys[INNER_CAP + 1];
+			Node* child[INNER_CAP + 2];
+			std::move(n->keys, n->keys + p, keys);
+			keys[p] = std::move(key);
+			std::move(n->keys + p, n->keys + INNER_CAP, keys + p + 1);
+			std::copy(n->child, n->child + p + 1, child);
+			child[p + 1] = right;
+			std::copy(n->child + p + 1, n->child + INNER_CAP + 1, child + p + 2);
+
+			size_t mid = INNER_CAP / 2;
+			Inner* sibling = new Inner();
+			n->count = uint32_t(mid);
+			sibling->count = uint32_t(INNER_CAP - mid);
+			std::move(keys, keys + mid, n->keys);
+			std::copy(child, child + mid + 1, n->child);
+			std::move(keys + mid + 1, keys + INNER_CAP + 1, sibling->keys);
+			std::copy(child + mid + 1, child + INNER_CAP + 2, sibling->child);
+			key = std::move(keys[mid]);
+			right = sibling;
+			--level;
+		}
+		Inner* top = new Inner();
+		top->count = 1;
+		top->keys[0] = std::move(key);
+		top->child[0] = root;
+		top->child[1] = right;
+		root = top;
+		++depth;
+	}
+
+	// Refills path[level]'s child at pos[level], which fell below the
+	// minimum, from a sibling, merging the two when the sibling has no
+	// entry to spare; merges can empty the parent in turn
+	void rebalance(Inner** path, size_t* pos, int level) {
+		for (; level >= 0; --level) {
+			Inner* parent = path[level];
+			size_t i = pos[level];
+			Node* n = parent->child[i];
+			size_t minCount = n->leaf ? LEAF_MIN : INNER_MIN;
+			if (n->count >= minCount)
+				return;
+
+			// work on the pair child[l], child[l + 1] around separator l
+			size_t l = i > 0 ? i - 1 : 0;
+			Node* a = parent->child[l];
+			Node* b = parent->child[l + 1];
+			Node* donor = n == a ? b : a;
+			if (donor->count > minCount) {
+				if (n->leaf)
+					borrowLeaf(parent, l, asLeaf(a), asLeaf(b), donor == a);
+				else
+					borrowInner(parent, l, asInner(a), asInner(b), donor == a);
+				return;
+			}
+
+			if (n->leaf)
+				mergeLeaves(asLeaf(a), asLeaf(b));
+			else
+				mergeInner(asInner(a), std::move(parent->keys[l]), asInner(b));
+			std::move(parent->keys + l + 1, parent->keys + parent->count, parent->keys + l);
+			std::copy(parent->child + l + 2, parent->child + parent->count + 1, parent->child + l + 1);
+			--parent->count;
+		}
+
+		// the root may lose its last separator, its only child takes over
+		if (!root->leaf && root->count == 0) {
+			Inner* old = asInner(root);
+			root = old->child[0];
+			delete old;
+			--depth;
+		}
+	}
+
+	static void borrowLeaf(Inner* parent, size_t l, Leaf* a, Leaf* b, bool fromLeft) {
+		if (fromLeft) {
+			std::move_backward(b->keys, b->keys + b->count, b->keys + b->count + 1);
+			std::move_backward(b->vals, b->vals + b->count, b->vals + b->count + 1);
+			b->keys[0] = std::move(a->keys[a->count - 1]);
+			b->vals[0] = std::move(a->vals[a->count - 1]);
+			--a->count;
+			++b->count;
+		}
+		else {
+			a->keys[a->count] = std::move(b->keys[0]);
+			a->vals[a->count] = std::move(b->vals[0]);
+			++a->count;
+			std::move(b->keys + 1, b->keys + b->count, b->keys);
+			std::move(b->vals + 1, b->vals + b->count, b->vals);
+			--b->count;
+		}
+		parent->keys[l] = b->keys[0];
+	}
+
+	// Rotates one child through the separator between a and b
+	static void borrowInner(Inner* parent, size_t l, Inner* a, Inner* b, bool fromLeft) {
+		if (fromLeft) {
+			std::move_backward(b->keys, b->keys + b->count, b->keys + b->count + 1);
+			std::move_backward(b->child, b->child + b->count + 1, b->child + b->count + 2);
+			b->keys[0] = std::move(parent->keys[l]);
+			b->child[0] = a->child[a->count];
+			parent->keys[l] = std::move(a->keys[a->count - 1]);
+			--a->count;
+			++b->count;
+		}
+		else {
+			a->keys[a->count] = std::move(parent->keys[l]);
+			a->child[a->count + 1] = b->child[0];
+			++a->count;
+			parent->keys[l] = std::move(b->keys[0]);
+			std::move(b->keys + 1, b->keys + b->count, b->keys);
+			std::copy(b->child + 1, b->child + b->count + 1, b->child);
+			--b->count;
+		}
+	}
+
+	static void mergeLeaves(Leaf* a, Leaf* b) {
+		std::move(b->keys, b->keys + b->count, a->keys + a->count);
+		std::move(b->vals, b->vals + b->count, a->vals + a->count);
+		a->count += b->count;
+		a->next = b->next;
+		delete b;
+	}
+
+	static void mergeInner(Inner* a, K separator, Inner* b) {
+		a->keys[a->count] = std::move(separator);
+		std::move(b->keys, b->keys + b->count, a->keys + a->count + 1);
+		std::copy(b->child, b->child + b->count + 1, a->child + a->count + 1);
+		a->count += b->count + 1;
+		delete b;
+	}
+
+	// Checks order, fill and separators of a subtree whose keys must lie in
+	// [lo, hi) (null bounds are open); returns its leaf depth or -1
+	int check(const Node* n, const K* lo, const K* hi, bool isRoot) const {
+		if (!isRoot && n->count < (n->leaf ? LEAF_MIN : INNER_MIN))
+			return -1;
+		if (n->leaf) {
+			const Leaf* f = asLeaf(n);
+			for (size_t i = 0; i < f->count; ++i)
+				if ((i > 0 && !(f->keys[i - 1] < f->keys[i])) || (lo && f->keys[i] < *lo) || (hi && !(f->keys[i] < *hi)))
+					return -1;
+			return 0;
+		}
+		const Inner* in = asInner(n);
+		int d = -1;
+		for (size_t i = 0; i <= in->count; ++i) {
+			if (i > 0 && i < in->count && !(in->keys[i - 1] < in->keys[i]))
+				return -1;
+			int c = check(in->child[i], i > 0 ? &in->keys[i - 1] : lo, i < in->count ? &in->keys[i] : hi, false);
+			if (c < 0 || (d >= 0 && c != d))
+				return -1;
+			d = c;
+		}
+		return d + 1;
+	}
+
+public:
+	BTreeTable() noexcept : root(nullptr), count(0), depth(0) {}
+
+	BTreeTable(const BTreeTable& other) : root(nullptr), count(other.count), depth(other.depth) {
+		Leaf* prev = nullptr;
+		if (other.root)
+			root = clone(other.root, prev);
+	}
+
+	BTreeTable(BTreeTable&& other) noexcept : BTreeTable() {
+		swap(other);
+	}
+
+	~BTreeTable() {
+		if (root)
+			destroy(root);
+	}
+
+	BTreeTable& operator=(const BTreeTable& other) {
+		if (this != &other) {
+			BTreeTable copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	BTreeTable& operator=(BTreeTable&& other) noexcept {
+		if (this != &other)
+			swap(other);
+		return *this;
+	}
+
+	void swap(BTreeTable& other) noexcept {
+		std::swap(root, other.root);
+		std::swap(count, other.count);
+		std::swap(depth, other.depth);
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	// Levels of nodes, 1 for a lone leaf
+	int height() const { return depth + 1; }
+
+	// Entries one leaf holds at most
+	static constexpr size_t leafCapacity() { return LEAF_CAP; }
+
+	// Checks ordering, separators, fill and uniform leaf depth (for tests)
+	bool isValid() const { return !root || check(root, nullptr, nullptr, true) == depth; }
+
+	void clear() noexcept {
+		if (root)
+			destroy(root);
+		root = nullptr;
+		count = 0;
+		depth = 0;
+	}
+
+	V* find(const K& key) {
+		Leaf* n = findLeaf(key);
+		if (!n)
+			return nullptr;
+		size_t i = leafIndex(n, key);
+		return i < n->count && !(key < n->keys[i]) ? &n->vals[i] : nullptr;
+	}
+
+	const V* find(const K& key) const {
+		return const_cast<BTreeTable*>(this)->find(key);
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		if (!root)
+			root = new Leaf();
+		Inner* path[MAX_DEPTH];
+		size_t pos[MAX_DEPTH];
+		Node* n = root;
+		for (int level = 0; !n->leaf; ++level) {
+			path[level] = asInner(n);
+			pos[level] = childIndex(asInner(n), key);
+			n = asInner(n)->child[pos[level]];
+		}
+		Leaf* leaf = asLeaf(n);
+		size_t i = leafIndex(leaf, key);
+		if (i < leaf->count && !(key < leaf->keys[i]))
+			return false;
+
+		if (leaf->count == LEAF_CAP) {
+			// split in half, the right half goes to a new leaf
+			Leaf* right = new Leaf();
+			size_t half = LEAF_CAP / 2;
+			right->count = uint32_t(LEAF_CAP - half);
+			std::move(leaf->keys + half, leaf->keys + LEAF_CAP, right->keys);
+			std::move(leaf->vals + half, leaf->vals + LEAF_CAP, right->vals);
+			leaf->count = uint32_t(half);
+			right->next = leaf->next;
+			leaf->next = right;
+			insertUp(path, pos, depth - 1, right->keys[0], right);
+			if (i > half) {
+				leaf = right;
+				i -= half;
+			}
+		}
+
+		std::move_backward(leaf->keys + i, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+		std::move_backward(leaf->vals + i, leaf->vals + leaf->count, leaf->vals + leaf->count + 1);
+		leaf->keys[i] = key;
+		leaf->vals[i] = value;
+		++leaf->count;
+		++count;
+		return true;
+	}
+
+	bool erase(const K& key) {
+		if (!root)
+			return false;
+		Inner* path[MAX_DEPTH];
+		size_t pos[MAX_DEPTH];
+		Node* n = root;
+		for (int level = 0; !n->leaf; ++level) {
+			path[level] = asInner(n);
+			pos[level] = childIndex(asInner(n), key);
+			n = asInner(n)->child[pos[level]];
+		}
+		Leaf* leaf = asLeaf(n);
+		size_t i = leafIndex(leaf, key);
+		if (i == leaf->count || key < leaf->keys[i])
+			return false;
+
+		std::move(leaf->keys + i + 1, leaf->keys + leaf->count, leaf->keys + i);
+		std::move(leaf->vals + i + 1, leaf->vals + leaf->count, leaf->vals + i);
+		--leaf->count;
+		// release what the vacated last slots own
+		leaf->keys[leaf->count] = K();
+		leaf->vals[leaf->count] = V();
+		--count;
+		rebalance(path, pos, depth - 1);
+		return true;
+	}
+
+	// f(key, value) for every entry with lo <= key < hi, in key order
+	template <class F>
+	void range(const K& lo, const K& hi, F f) const {
+		const Leaf* n = findLeaf(lo);
+		size_t i = n ? leafIndex(n, lo) : 0;
+		for (; n; n = n->next, i = 0)
+			for (; i < n->count; ++i) {
+				if (!(n->keys[i] < hi))
+					return;
+				f(n->keys[i], n->vals[i]);
+			}
+	}
+
+	// f(key, value) for every entry in key order
+	template <class F>
+	void for_each(F f) const {
+		for (const Leaf* n = firstLeaf(); n; n = n->next)
+			for (size_t i = 0; i < n->count; ++i)
+				f(n->keys[i], n->vals[i]);
+	}
+
+	template <class F>
+	void for_each(F f) {
+		for (Leaf* n = firstLeaf(); n; n = n->next)
+			for (size_t i = 0; i < n->count; ++i)
+				f(static_cast<const K&>(n->keys[i]), n->vals[i]);
+	}
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef __COEFFICIENT_H__
+#define __COEFFICIENT_H__
+
+#include <cmath>
+#include <stdexcept>
+
+// What the translator needs from a polynomial coefficient type beyond ring
+// arithmetic: turning a numeric literal into a coefficient, raising one
+// constant to another and reading a constant as a monomial exponent. The
+// primary template covers floating point, other types specialize it.
+template <class Coef>
+struct CoefficientTraits {
+	static Coef fromNumber(double v) { return Coef(v); }
+
+	static Coef power(const Coef& base, const Coef& e) { return std::pow(base, e); }
+
+	// False if e is not an integer in [0, limit]
+	static bool toExponent(const Coef& e, unsigned limit, unsigned& out) {
+		if (e < 0 || e != std::floor(e) || e > limit)
+			return false;
+		out = static_cast<unsigned>(e);
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef __CONCURRENT_HASH_TABLE_H__
+#define __CONCURRENT_HASH_TABLE_H__
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include "hash_table.h"
+#include "table_hash.h"
+
+// Hash table shared between threads. Keys are spread by the top bits of
+// their hash over a power-of-two number of shards, each a HashTable behind
+// its own reader-writer lock, so lookups of different keys rarely wait for
+// each other and never for a lookup. Every shard sits on its own cache
+// lines so that taking one lock does not invalidate its neighbours.
+// Values are copied out under the lock: a pointer into a shard would not
+// survive a concurrent insert that rehashes it.
+template <class K, class V, class Hash = TableHash<K>, class Eq = std::equal_to<>>
+class ConcurrentHashTable {
+	typedef HashTable<K, V, Hash, Eq> Table;
+
+	struct alignas(64) Shard {
+		mutable std::shared_mutex lock;
+		Table table;
+	};
+
+	std::unique_ptr<Shard[]> shards;
+	size_t shardCount;
+	int shardShift; // hash bits below the shard index
+	Hash hasher;
+
+	template <class Q>
+	Shard& shardOf(const Q& key) const {
+		size_t h = hasher(key);
+		// a shift by the full width is undefined, one shard takes no bits
+		return shards[shardCount == 1 ? 0 : h >> shardShift];
+	}
+
+public:
+	static constexpr size_t DEFAULT_SHARDS = 64;
+
+	// shardsWanted is rounded up to a power of two
+	explicit ConcurrentHashTable(size_t shardsWanted = DEFAULT_SHARDS) {
+		if (shardsWanted == 0)
+			throw std::invalid_argument("ConcurrentHashTable needs at least one shard");
+		shardCount = std::bit_ceil(shardsWanted);
+		shardShift = int(8 * sizeof(size_t)) - std::countr_zero(shardCount);
+		shards.reset(new Shard[shardCount]);
+	}
+
+	ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+	ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+	size_t shardTotal() const { return shardCount; }
+
+	// Exact only while no other thread modifies the table
+	size_t size() const {
+		size_t n = 0;
+		for (size_t i = 0; i < shardCount; ++i) {
+			std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+			n += shards[i].table.size();
+		}
+		return n;
+	}
+
+	bool empty() const { return size() == 0; }
+
+	// Makes room for n entries spread evenly over the shards
+	void reserve(size_t n) {
+		for (size_t i = 0; i < shardCount; ++i) {
+			std::unique_lock<std::shared_mutex> guard(shards[i].lock);
+			shards[i].table.reserve(n / shardCount + 1);
+		}
+	}
+
+	void clear() {
+		for (size_t i = 0; i < shardCount; ++i) {
+			std::unique_lock<std::shared_mutex> guard(shards[i].lock);
+			shards[i].table.clear();
+		}
+	}
+
+	// Copies the value of key into out, false if the key is absent
+	template <class Q>
+	bool find(const Q& key, V& out) const {
+		Shard& s = shardOf(key);
+		std::shared_lock<std::shared_mutex> guard(s.lock);
+		const V* v = static_cast<const Table&>(s.table).find(key);
+		if (!v)
+			return false;
+		out = *v;
+		return true;
+	}
+
+	template <class Q>
+	bool contains(const Q& key) const {
+		Shard& s = shardOf(key);
+		std::shared_lock<std::shared_mutex> guard(s.lock);
+		return static_cast<const Table&>(s.table).find(key) != nullptr;
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		Shard& s = shardOf(key);
+		std::unique_lock<std::shared_mutex> guard(s.lock);
+		return s.table.insert(key, value);
+	}
+
+	// Inserts or overwrites, true if the key was new
+	bool assign(const K& key, const V& value) {
+		Shard& s = shardOf(key);
+		std::unique_lock<std::shared_mutex> guard(s.lock);
+		if (V* v = s.table.find(key)) {
+			*v = value;
+			return false;
+		}
+		return s.table.insert(key, value);
+	}
+
+	// Calls f(value) under the shard's write lock, false if the key is absent
+	template <class Q, class F>
+	bool update(const Q& key, F f) {
+		Shard& s = shardOf(key);
+		std::unique_lock<std::shared_mutex> guard(s.lock);
+		V* v = s.table.find(key);
+		if (!v)
+			return false;
+		f(*v);
+		return true;
+	}
+
+	template <class Q>
+	bool erase(const Q& key) {
+		Shard& s = shardOf(key);
+		std::unique_lock<std::shared_mutex> guard(s.lock);
+		return s.table.erase(key);
+	}
+
+	// f(key, value) for every entry, one shard at a time under its read
+	// lock: not a snapshot of the whole table while writers run, and f must
+	// not call back into the table
+	template <class F>
+	void for_each(F f) const {
+		for (size_t i = 0; i < shardCount; ++i) {
+			std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+			static_cast<const Table&>(shards[i].table).for_each(f);
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef __COW_VECTOR_H__
+#define __COW_VECTOR_H__
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Copy-on-write vector. Copies share one immutable block with an atomic
+// reference count, so copying costs a pointer and an increment; edit()
+// clones the block only if somebody else still holds it. An empty vector
+// owns no block at all.
+template <class T>
+class CowVector {
+	struct Block {
+		std::atomic<long> refs;
+		std::vector<T> items;
+
+		explicit Block(std::vector<T>&& v) : refs(1), items(std::move(v)) {}
+	};
+
+	Block* block;
+
+	static const std::vector<T>& none() {
+		static const std::vector<T> empty;
+		return empty;
+	}
+
+	void release() noexcept {
+		// acq_rel: the last owner must see all writes made before the others let go
+		if (block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete block;
+		block = nullptr;
+	}
+
+public:
+	CowVector() noexcept : block(nullptr) {}
+
+	explicit CowVector(std::vector<T>&& items) : block(nullptr) {
+		if (!items.empty())
+			block = new Block(std::move(items));
+	}
+
+	CowVector(const CowVector& other) noexcept : block(other.block) {
+		if (block)
+			block->refs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	CowVector(CowVector&& other) noexcept : block(other.block) {
+		other.block = nullptr;
+	}
+
+	~CowVector() {
+		release();
+	}
+
+	CowVector& operator=(const CowVector& other) noexcept {
+		if (block != other.block) {
+			if (other.block)
+				other.block->refs.fetch_add(1, std::memory_order_relaxed);
+			release();
+			block = other.block;
+		}
+		return *this;
+	}
+
+	CowVector& operator=(CowVector&& other) noexcept {
+		if (this != &other) {
+			release();
+			block = other.block;
+			other.block = nullptr;
+		}
+		return *this;
+	}
+
+	const std::vector<T>& view() const noexcept {
+		return block ? block->items : none();
+	}
+
+	// Exclusive access for mutation, detaching from other owners first
+	std::vector<T>& edit() {
+		if (!block) {
+			block = new Block(std::vector<T>());
+		}
+		else if (block->refs.load(std::memory_order_acquire) != 1) {
+			Block* copy = new Block(std::vector<T>(block->items));
+			release();
+			block = copy;
+		}
+		return block->items;
+	}
+
+	long useCount() const noexcept {
+		return block ? block->refs.load(std::memory_order_relaxed) : 0;
+	}
+
+	bool sharesWith(const CowVector& other) const noexcept {
+		return block != nullptr && block == other.block;
+	}
+
+	size_t size() const noexcept { return view().size(); }
+	bool empty() const noexcept { return block == nullptr || block->items.empty(); }
+	const T& operator[](size_t i) const { return view()[i]; }
+	typename std::vector<T>::const_iterator begin() const noexcept { return view().begin(); }
+	typename std::vector<T>::const_iterator end() const noexcept { return view().end(); }
+
+	bool operator==(const CowVector& other) const {
+		return block == other.block || view() == other.view();
+	}
+
+	bool operator!=(const CowVector& other) const {
+		return !(*this == other);
+	}
+};
+
+#endif
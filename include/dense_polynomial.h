@@ -0,0 +1,306 @@
+#ifndef __DENSE_POLYNOMIAL_H__
+#define __DENSE_POLYNOMIAL_H__
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "multipoint_eval.h"
+#include "polynomial.h"
+
+// Dense univariate polynomial in x: coefs[i] is the coefficient of x^i, with
+// no trailing zeros. Multiplication switches from schoolbook to Karatsuba to
+// FFT as the degree grows; the crossovers come from bench_dense_polynomial.
+// Converts to and from the sparse Polynomial the translator produces.
+class DensePolynomial {
+public:
+	enum MulMethod { MUL_AUTO, MUL_SCHOOLBOOK, MUL_KARATSUBA, MUL_FFT };
+
+	// Operand sizes (number of coefficients of the shorter factor)
+	static constexpr size_t KARATSUBA_THRESHOLD = 32;
+	static constexpr size_t FFT_THRESHOLD = 2048;
+
+private:
+	std::vector<double> coefs;
+
+	void trim() {
+		while (!coefs.empty() && coefs.back() == 0)
+			coefs.pop_back();
+	}
+
+	// res[0 .. n + m - 1) += a * b
+	static void schoolbook(const double* a, size_t n, const double* b, size_t m, double* res) {
+		for (size_t i = 0; i < n; ++i) {
+			double ai = a[i];
+			for (size_t j = 0; j < m; ++j)
+				res[i + j] += ai * b[j];
+		}
+	}
+
+	// res[0 .. 2n - 1) = a * b for two factors of n coefficients
+	static void karatsuba(const double* a, const double* b, size_t n, double* res) {
+		if (n < KARATSUBA_THRESHOLD) {
+			std::fill(res, res + 2 * n - 1, 0.0);
+			schoolbook(a, n, b, n, res);
+			return;
+		}
+
+		// a = a0 + x^h * a1, b = b0 + x^h * b1, with a1 and b1 the longer halves
+		size_t h = n / 2, hi = n - h;
+		const double* a1 = a + h;
+		const double* b1 = b + h;
+
+		// z0 = a0 * b0 and z2 = a1 * b1 go straight to their places in res
+		karatsuba(a, b, h, res);
+		res[2 * h - 1] = 0;
+		karatsuba(a1, b1, hi, res + 2 * h);
+
+		std::vector<double> sa(a1, a1 + hi), sb(b1, b1 + hi), z1(2 * hi - 1);
+		for (size_t i = 0; i < h; ++i) {
+			sa[i] += a[i];
+			sb[i] += b[i];
+		}
+		karatsuba(sa.data(), sb.data(), hi, z1.data());
+
+		// z1 = (a0 + a1)(b0 + b1) - z0 - z2
+		for (size_t i = 0; i < 2 * h - 1; ++i)
+			z1[i] -= res[i];
+		for (size_t i = 0; i < 2 * hi - 1; ++i)
+			z1[i] -= res[2 * h + i];
+		for (size_t i = 0; i < 2 * hi - 1; ++i)
+			res[h + i] += z1[i];
+	}
+
+	// Unbalanced factors are cut into pieces the size of the shorter one
+	static std::vector<double> mulKaratsuba(const std::vector<double>& a, const std::vector<double>& b) {
+		const std::vector<double>& s = a.size() <= b.size() ? a : b;
+		const std::vector<double>& l = a.size() <= b.size() ? b : a;
+		size_t m = s.size();
+		std::vector<double> res(a.size() + b.size() - 1, 0.0);
+		std::vector<double> piece(m), part(2 * m - 1);
+
+		for (size_t off = 0; off < l.size(); off += m) {
+			size_t len = std::min(m, l.size() - off);
+			std::fill(piece.begin(), piece.end(), 0.0);
+			std::copy(l.begin() + off, l.begin() + off + len, piece.begin());
+			karatsuba(piece.data(), s.data(), m, part.data());
+			for (size_t i = 0; i < 2 * m - 1 && off + i < res.size(); ++i)
+				res[off + i] += part[i];
+		}
+		return res;
+	}
+
+	static std::vector<double> mulSchoolbook(const std::vector<double>& a, const std::vector<double>& b) {
+		std::vector<double> res(a.size() + b.size() - 1, 0.0);
+		schoolbook(a.data(), a.size(), b.data(), b.size(), res.data());
+		return res;
+	}
+
+	// In-place iterative radix-2 FFT, size must be a power of two
+	static void fft(std::vector<std::complex<double>>& data, bool inverse) {
+		size_t n = data.size();
+		for (size_t i = 1, j = 0; i < n; ++i) {
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+			if (i < j)
+				std::swap(data[i], data[j]);
+		}
+
+		const double pi = 3.14159265358979323846;
+		for (size_t len = 2; len <= n; len <<= 1) {
+			double angle = 2 * pi / double(len) * (inverse ? 1 : -1);
+			size_t half = len / 2;
+			// twiddles computed directly rather than by repeated multiplication
+			// to keep rounding errors from accumulating along the butterfly
+			std::vector<std::complex<double>> w(half);
+			for (size_t k = 0; k < half; ++k)
+				w[k] = std::complex<double>(std::cos(angle * double(k)), std::sin(angle * double(k)));
+
+			for (size_t i = 0; i < n; i += len)
+				for (size_t k = 0; k < half; ++k) {
+					std::complex<double> u = data[i + k];
+					std::complex<double> v = data[i + k + half] * w[k];
+					data[i + k] = u + v;
+					data[i + k + half] = u - v;
+				}
+		}
+
+		if (inverse)
+			for (size_t i = 0; i < n; ++i)
+				data[i] /= double(n);
+	}
+
+	// Both real factors ride in one complex signal c = a + i*b; since
+	// c^2 = a^2 - b^2 + 2i*ab, the product is Im(IFFT(FFT(c)^2)) / 2.
+	// The result carries rounding error of order eps * log(n) * max|a| * max|b| * n.
+	static std::vector<double> mulFFT(const std::vector<double>& a, const std::vector<double>& b) {
+		size_t resSize = a.size() + b.size() - 1;
+		size_t n = 1;
+		while (n < resSize)
+			n <<= 1;
+
+		std::vector<std::complex<double>> c(n);
+		for (size_t i = 0; i < a.size(); ++i)
+			c[i].real(a[i]);
+		for (size_t i = 0; i < b.size(); ++i)
+			c[i].imag(b[i]);
+
+		fft(c, false);
+		for (size_t i = 0; i < n; ++i)
+			c[i] *= c[i];
+		fft(c, true);
+
+		std::vector<double> res(resSize);
+		for (size_t i = 0; i < resSize; ++i)
+			res[i] = c[i].imag() / 2;
+		return res;
+	}
+
+public:
+	DensePolynomial() {}
+	DensePolynomial(double c) {
+		if (c != 0)
+			coefs.push_back(c);
+	}
+	explicit DensePolynomial(const std::vector<double>& c) : coefs(c) {
+		trim();
+	}
+
+	// From a sparse polynomial in x only
+	explicit DensePolynomial(const Polynomial& p) {
+		const std::vector<Monomial>& terms = p.monomials();
+		if (terms.empty())
+			return;
+
+		for (size_t i = 0; i < terms.size(); ++i)
+			if (terms[i].degY() != 0 || terms[i].degZ() != 0)
+				throw std::invalid_argument("Dense polynomial can only depend on x");
+
+		// sparse terms are sorted by descending degree
+		coefs.assign(terms[0].degX() + 1, 0.0);
+		for (size_t i = 0; i < terms.size(); ++i)
+			coefs[terms[i].degX()] = terms[i].coef;
+	}
+
+	Polynomial toSparse() const {
+		std::vector<Monomial> terms;
+		for (size_t i = coefs.size(); i-- > 0;)
+			if (coefs[i] != 0)
+				terms.push_back(Monomial(coefs[i], unsigned(i), 0, 0));
+		return Polynomial(terms);
+	}
+
+	const std::vector<double>& coefficients() const { return coefs; }
+	double coefficient(size_t i) const { return i < coefs.size() ? coefs[i] : 0; }
+	bool isZero() const { return coefs.empty(); }
+
+	// -1 for the zero polynomial
+	int degree() const { return int(coefs.size()) - 1; }
+
+	double evaluate(double x) const {
+		double res = 0;
+		for (size_t i = coefs.size(); i-- > 0;)
+			res = res * x + coefs[i];
+		return res;
+	}
+
+	// Evaluation at many points with blocked, vectorized Horner or Estrin
+	void evaluate(std::span<const double> xs, std::span<double> out,
+		MultiPointEval::Scheme scheme = MultiPointEval::HORNER) const {
+		MultiPointEval::dense(coefs, xs, out, scheme);
+	}
+
+	static DensePolynomial multiply(const DensePolynomial& a, const DensePolynomial& b, MulMethod method = MUL_AUTO) {
+		if (a.isZero() || b.isZero())
+			return DensePolynomial();
+
+		if (method == MUL_AUTO) {
+			size_t shorter = std::min(a.coefs.size(), b.coefs.size());
+			method = shorter < KARATSUBA_THRESHOLD ? MUL_SCHOOLBOOK
+				: shorter < FFT_THRESHOLD ? MUL_KARATSUBA : MUL_FFT;
+		}
+
+		DensePolynomial res;
+		switch (method) {
+		case MUL_SCHOOLBOOK: res.coefs = mulSchoolbook(a.coefs, b.coefs); break;
+		case MUL_KARATSUBA: res.coefs = mulKaratsuba(a.coefs, b.coefs); break;
+		default: res.coefs = mulFFT(a.coefs, b.coefs); break;
+		}
+		res.trim();
+		return res;
+	}
+
+	DensePolynomial operator+(const DensePolynomial& other) const {
+		DensePolynomial res(*this);
+		if (res.coefs.size() < other.coefs.size())
+			res.coefs.resize(other.coefs.size(), 0.0);
+		for (size_t i = 0; i < other.coefs.size(); ++i)
+			res.coefs[i] += other.coefs[i];
+		res.trim();
+		return res;
+	}
+
+	DensePolynomial operator-(const DensePolynomial& other) const { return *this + (-other); }
+
+	DensePolynomial operator-() const {
+		DensePolynomial res(*this);
+		for (size_t i = 0; i < res.coefs.size(); ++i)
+			res.coefs[i] = -res.coefs[i];
+		return res;
+	}
+
+	DensePolynomial operator*(const DensePolynomial& other) const { return multiply(*this, other); }
+
+	DensePolynomial operator*(double c) const {
+		if (c == 0)
+			return DensePolynomial();
+		DensePolynomial res(*this);
+		for (size_t i = 0; i < res.coefs.size(); ++i)
+			res.coefs[i] *= c;
+		return res;
+	}
+
+	DensePolynomial operator/(double c) const {
+		if (c == 0)
+			throw std::invalid_argument("Division by zero!");
+		DensePolynomial res(*this);
+		for (size_t i = 0; i < res.coefs.size(); ++i)
+			res.coefs[i] /= c;
+		return res;
+	}
+
+	friend DensePolynomial operator*(double c, const DensePolynomial& p) { return p * c; }
+
+	DensePolynomial pow(unsigned n) const {
+		DensePolynomial res(1.0);
+		DensePolynomial base(*this);
+		while (n) {
+			if (n & 1)
+				res = res * base;
+			n >>= 1;
+			if (n)
+				base = base * base;
+		}
+		return res;
+	}
+
+	DensePolynomial& operator+=(const DensePolynomial& other) { return *this = *this + other; }
+	DensePolynomial& operator-=(const DensePolynomial& other) { return *this = *this - other; }
+	DensePolynomial& operator*=(const DensePolynomial& other) { return *this = *this * other; }
+	DensePolynomial& operator*=(double c) { return *this = *this * c; }
+	DensePolynomial& operator/=(double c) { return *this = *this / c; }
+
+	bool operator==(const DensePolynomial& other) const { return coefs == other.coefs; }
+	bool operator!=(const DensePolynomial& other) const { return !(*this == other); }
+
+	friend std::ostream& operator<<(std::ostream& ostr, const DensePolynomial& p) {
+		return ostr << p.toSparse();
+	}
+};
+
+#endif
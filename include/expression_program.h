@@ -0,0 +1,168 @@
+#ifndef __EXPRESSION_PROGRAM_H__
+#define __EXPRESSION_PROGRAM_H__
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "string_interner.h"
+
+// Expression compiled to postfix bytecode for a stack machine: operands
+// are pushed from the constant pool or from variable slots, operators pop
+// their operands and push the result. The slot map gives the name of each
+// variable, numbered in order of first appearance, and callers pass one
+// value per slot. Names are IDs of a StringInterner that programs compiled
+// by one translator share, so each name is stored once however many
+// programs use it.
+
+enum ProgramOp : uint8_t {
+	OP_CONST, // push constants[arg]
+	OP_VAR,   // push values[arg]
+	OP_NEG,
+	OP_ADD,
+	OP_SUB,
+	OP_MUL,
+	OP_DIV,
+	OP_POW
+};
+
+// Opcode in the low 8 bits, argument in the high 24
+struct ProgramInstruction {
+	uint32_t word;
+
+	static constexpr uint32_t MAX_ARG = (1u << 24) - 1;
+
+	ProgramOp op() const { return ProgramOp(word & 0xFF); }
+	uint32_t arg() const { return word >> 8; }
+};
+
+static_assert(sizeof(ProgramInstruction) == 4, "ProgramInstruction is stored in program files");
+
+// Stack depth change of an instruction and the operands it needs
+inline size_t programPops(ProgramOp op) { return op == OP_CONST || op == OP_VAR ? 0 : op == OP_NEG ? 1 : 2; }
+
+// Runs length instructions of a complete program (one that leaves exactly
+// one value) with a stack of maxStack values; the program is trusted to
+// stay within its constants, values and stack. The top of the stack is
+// kept in acc, below it the stack holds a dummy entry and the rest.
+// Division by zero throws, as ArithmeticTranslator::Calculate does.
+inline double runProgram(const ProgramInstruction* code, size_t length, const double* constants, const double* values,
+	size_t maxStack) {
+	static constexpr size_t LOCAL_STACK = 64;
+	double local[LOCAL_STACK];
+	std::vector<double> heap;
+	double* stack = local;
+	if (maxStack > LOCAL_STACK) {
+		heap.resize(maxStack);
+		stack = heap.data();
+	}
+
+	double acc = 0;
+	size_t top = 0;
+	for (size_t i = 0; i < length; ++i) {
+		uint32_t arg = code[i].arg();
+		switch (code[i].op()) {
+		case OP_CONST: stack[top++] = acc; acc = constants[arg]; break;
+		case OP_VAR: stack[top++] = acc; acc = values[arg]; break;
+		case OP_NEG: acc = -acc; break;
+		case OP_ADD: acc = stack[--top] + acc; break;
+		case OP_SUB: acc = stack[--top] - acc; break;
+		case OP_MUL: acc = stack[--top] * acc; break;
+		case OP_DIV:
+			if (acc == 0)
+				throw std::invalid_argument("Division by zero!");
+			acc = stack[--top] / acc;
+			break;
+		case OP_POW: acc = std::pow(stack[--top], acc); break;
+		}
+	}
+	return acc;
+}
+
+class ExpressionProgram {
+	std::vector<ProgramInstruction> instructions;
+	std::vector<double> pool;
+	std::vector<uint32_t> slotIds;
+	std::shared_ptr<StringInterner> interner;
+	size_t depth;    // stack depth after the last instruction
+	size_t maxDepth;
+
+public:
+	// Variables are named in names, or in an interner of the program's own
+	explicit ExpressionProgram(std::shared_ptr<StringInterner> names = nullptr)
+		: interner(std::move(names)), depth(0), maxDepth(0) {}
+
+	// Appends an instruction, checking that its operands are on the stack
+	void emit(ProgramOp op, uint32_t arg = 0) {
+		size_t pops = programPops(op);
+		if (depth < pops)
+			throw std::invalid_argument("Invalid expression: missing operand");
+		if (arg > ProgramInstruction::MAX_ARG)
+			throw std::length_error("Expression has too many constants or variables");
+		depth = depth - pops + 1;
+		if (depth > maxDepth)
+			maxDepth = depth;
+		instructions.push_back({ uint32_t(op) | arg << 8 });
+	}
+
+	void pushConstant(double value) {
+		pool.push_back(value);
+		emit(OP_CONST, uint32_t(pool.size() - 1));
+	}
+
+	// Pushes a variable, giving it the next slot on its first appearance;
+	// a formula has few variables, so the slot map is searched linearly
+	void pushVariable(std::string_view name) {
+		if (!interner)
+			interner = std::make_shared<StringInterner>();
+		uint32_t id = interner->intern(name);
+		size_t slot = 0;
+		while (slot < slotIds.size() && slotIds[slot] != id)
+			++slot;
+		if (slot == slotIds.size())
+			slotIds.push_back(id);
+		emit(OP_VAR, uint32_t(slot));
+	}
+
+	// A program is complete when it leaves exactly one value
+	bool isComplete() const { return depth == 1; }
+
+	const std::vector<ProgramInstruction>& code() const { return instructions; }
+	const std::vector<double>& constants() const { return pool; }
+	size_t maxStack() const { return maxDepth; }
+
+	size_t variableCount() const { return slotIds.size(); }
+	// Interner IDs of the variables, by slot
+	const std::vector<uint32_t>& variableIds() const { return slotIds; }
+	std::string_view variable(size_t slot) const { return interner->name(slotIds[slot]); }
+	const std::shared_ptr<StringInterner>& names() const { return interner; }
+
+	// Slot of a variable, or variableCount() if the program doesn't use it
+	size_t slotOf(std::string_view name) const {
+		uint32_t id = interner ? interner->find(name) : StringInterner::NONE;
+		size_t slot = 0;
+		while (slot < slotIds.size() && slotIds[slot] != id)
+			++slot;
+		return slot;
+	}
+
+	// values[slot] for every slot
+	double evaluate(const double* values) const {
+		if (!isComplete())
+			throw std::invalid_argument("Invalid expression: the program doesn't leave exactly one value");
+		return runProgram(instructions.data(), instructions.size(), pool.data(), values, maxDepth);
+	}
+
+	double evaluate(const std::vector<double>& values) const {
+		if (values.size() < slotIds.size())
+			throw std::invalid_argument("Expected a value for each of the " + std::to_string(slotIds.size()) + " variables");
+		return evaluate(values.data());
+	}
+};
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef __HASH_TABLE_H__
+#define __HASH_TABLE_H__
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include "simd_match.h"
+#include "table_hash.h"
+
+// Probing over Swiss-table control bytes, shared by HashTable and the
+// read-only mapped tables of table_file.h. Every slot has a control byte:
+// EMPTY, DELETED, or the low 7 bits of the key's hash. Slots are probed in
+// aligned groups of GROUP, starting at the group picked by the hash bits
+// above the tag, with triangular steps that visit every group of a
+// power-of-two table.
+struct SwissControl {
+	static constexpr uint8_t EMPTY = 0x80;
+	static constexpr uint8_t DELETED = 0xFE;
+	static constexpr size_t GROUP = 16;
+	static constexpr size_t NONE = ~size_t(0);
+
+	static uint8_t tagOf(size_t h) { return uint8_t(h & 0x7F); }
+	static size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+	// First slot i on the probe sequence of h with a matching tag and
+	// match(i) true, NONE once a group with an EMPTY byte is passed or
+	// every group has been visited (only a damaged mapped table has none)
+	template <class Match>
+	static size_t find(const uint8_t* ctrl, size_t capacity, size_t h, Match match) {
+		if (capacity == 0)
+			return NONE;
+		uint8_t tag = tagOf(h);
+		size_t mask = capacity / GROUP - 1;
+		size_t g = (h >> 7) & mask;
+		for (size_t step = 1; step <= capacity / GROUP; ++step) {
+			const uint8_t* group = ctrl + g * GROUP;
+			for (uint32_t m = matchByte16(group, tag); m; m &= m - 1) {
+				size_t i = g * GROUP + size_t(std::countr_zero(m));
+				if (match(i))
+					return i;
+			}
+			if (matchByte16(group, EMPTY))
+				return NONE;
+			g = (g + step) & mask;
+		}
+		return NONE;
+	}
+
+	// First EMPTY or DELETED slot on the probe sequence of h
+	static size_t freeSlot(const uint8_t* ctrl, size_t capacity, size_t h) {
+		size_t mask = capacity / GROUP - 1;
+		size_t g = (h >> 7) & mask;
+		for (size_t step = 1;; ++step) {
+			uint32_t m = matchHighBit16(ctrl + g * GROUP);
+			if (m)
+				return g * GROUP + size_t(std::countr_zero(m));
+			g = (g + step) & mask;
+		}
+	}
+};
+
+// Open-addressing hash table in the Swiss-table style. Control bytes of a
+// group of 16 slots are compared with one SIMD instruction, and keys are
+// compared only where the 7 tag bits match.
+// A probe stops at the first group that still has an EMPTY byte, which the
+// 7/8 maximum load guarantees exists.
+// With a transparent Hash and Eq (TableHash<std::string> and the default
+// std::equal_to<>), find and erase accept any compatible key type, e.g. a
+// std::string_view for a std::string table, without building a K.
+template <class K, class V, class Hash = TableHash<K>, class Eq = std::equal_to<>>
+class HashTable {
+public:
+	enum ResizeMode {
+		RESIZE_AT_ONCE,    // rehash everything when the table fills up
+		RESIZE_INCREMENTAL // keep the old arrays and move MIGRATE_SLOTS of
+		                   // them per insert or erase; lookups check both
+	};
+
+	static constexpr size_t MIGRATE_SLOTS = 32;
+
+private:
+	struct Slot {
+		K key;
+		V value;
+	};
+
+	static constexpr uint8_t EMPTY = SwissControl::EMPTY;
+	static constexpr uint8_t DELETED = SwissControl::DELETED;
+	static constexpr size_t GROUP = SwissControl::GROUP;
+	static constexpr size_t MIN_CAPACITY = 16;
+	static constexpr size_t NONE = SwissControl::NONE;
+
+	uint8_t* ctrl;
+	Slot* slots;
+	size_t cap;
+	size_t count;      // entries in both arrays
+	size_t growthLeft; // inserts into EMPTY slots left before a rehash
+	Hash hasher;
+	Eq equal;
+
+	ResizeMode mode;
+	// arrays being drained by an incremental resize, slots before
+	// migrateNext are already moved (their control bytes are DELETED)
+	uint8_t* oldCtrl;
+	Slot* oldSlots;
+	size_t oldCap;
+	size_t migrateNext;
+
+	static size_t maxLoad(size_t capacity) { return SwissControl::maxLoad(capacity); }
+	static uint8_t tagOf(size_t h) { return SwissControl::tagOf(h); }
+
+	static constexpr bool TRANSPARENT = requires { typename Hash::is_transparent; typename Eq::is_transparent; };
+
+	// Index of key in the arrays c / s of the given capacity, or NONE
+	template <class Q>
+	size_t probe(const uint8_t* c, const Slot* s, size_t capacity, const Q& key, size_t h) const {
+		return SwissControl::find(c, capacity, h, [&](size_t i) { return equal(s[i].key, key); });
+	}
+
+	template <class Q>
+	Slot* findSlot(const Q& key) const {
+		size_t h = hasher(key);
+		size_t i = probe(ctrl, slots, cap, key, h);
+		if (i != NONE)
+			return &slots[i];
+		i = probe(oldCtrl, oldSlots, oldCap, key, h);
+		return i != NONE ? &oldSlots[i] : nullptr;
+	}
+
+	// Moves an entry into an EMPTY or DELETED slot of the current arrays
+	void place(Slot&& entry, size_t h) {
+		size_t j = SwissControl::freeSlot(ctrl, cap, h);
+		if (ctrl[j] == EMPTY)
+			--growthLeft;
+		ctrl[j] = tagOf(h);
+		std::construct_at(&slots[j], std::move(entry));
+	}
+
+	static void destroyAll(uint8_t* c, Slot* s, size_t capacity) noexcept {
+		for (size_t i = 0; i < capacity; ++i)
+			if (c[i] < EMPTY)
+				std::destroy_at(&s[i]);
+	}
+
+	static void deallocate(uint8_t*& c, Slot*& s, size_t& capacity) noexcept {
+		if (capacity) {
+			delete[] c;
+			std::allocator<Slot>().deallocate(s, capacity);
+		}
+		c = nullptr;
+		s = nullptr;
+		capacity = 0;
+	}
+
+	// Moves the old entries in [migrateNext, end) to the current arrays
+	void migrate(size_t end) {
+		for (; migrateNext < end; ++migrateNext) {
+			if (oldCtrl[migrateNext] >= EMPTY)
+				continue;
+			Slot& entry = oldSlots[migrateNext];
+			place(std::move(entry), hasher(entry.key));
+			std::destroy_at(&entry);
+			oldCtrl[migrateNext] = DELETED;
+		}
+		if (migrateNext == oldCap)
+			deallocate(oldCtrl, oldSlots, oldCap);
+	}
+
+	void migrateStep() {
+		if (oldCap)
+			migrate(std::min(oldCap, migrateNext + MIGRATE_SLOTS));
+	}
+
+	void finishMigration() {
+		if (oldCap)
+			migrate(oldCap);
+	}
+
+	// Replaces the arrays by new ones of the given capacity; an incremental
+	// rehash keeps the current ones as the old arrays and drains them later.
+	// Both new arrays are allocated before anything changes, so a failed
+	// allocation leaves the table as it was.
+	void rehash(size_t capacity, bool incremental = false) {
+		finishMigration();
+		std::unique_ptr<uint8_t[]> newCtrl(new uint8_t[capacity]);
+		Slot* newSlots = std::allocator<Slot>().allocate(capacity);
+		std::memset(newCtrl.get(), EMPTY, capacity);
+
+		oldCtrl = ctrl;
+		oldSlots = slots;
+		oldCap = cap;
+		migrateNext = 0;
+		ctrl = newCtrl.release();
+		slots = newSlots;
+		cap = capacity;
+		growthLeft = maxLoad(capacity);
+		if (!incremental)
+			finishMigration();
+	}
+
+	// Room for one more insert into an EMPTY slot. A table clogged with
+	// tombstones is rebuilt at the same size rather than doubled.
+	// While a migration runs, the new arrays receive at most the old
+	// entries plus one insert per MIGRATE_SLOTS old slots, well under their
+	// maximum load, so no second resize can start before it ends.
+	void reserveOne() {
+		if (growthLeft > 0)
+			return;
+		bool incremental = mode == RESIZE_INCREMENTAL;
+		if (cap == 0)
+			rehash(MIN_CAPACITY);
+		else if (count < maxLoad(cap) / 2)
+			rehash(cap, incremental);
+		else
+			rehash(cap * 2, incremental);
+	}
+
+	void eraseSlot(Slot* entry) {
+		std::destroy_at(entry);
+		--count;
+		if (entry < slots || entry >= slots + cap) {
+			// old arrays are only ever drained, tombstones are fine there
+			oldCtrl[entry - oldSlots] = DELETED;
+			return;
+		}
+		size_t i = size_t(entry - slots);
+		// probes for other keys never pass a group that still has an EMPTY
+		// byte, so the slot can become EMPTY again instead of a tombstone
+		if (matchByte16(ctrl + (i & ~(GROUP - 1)), EMPTY)) {
+			ctrl[i] = EMPTY;
+			++growthLeft;
+		}
+		else {
+			ctrl[i] = DELETED;
+		}
+	}
+
+	template <class F>
+	static void visit(uint8_t* c, Slot* s, size_t capacity, F& f) {
+		for (size_t i = 0; i < capacity; ++i)
+			if (c[i] < EMPTY)
+				f(static_cast<const K&>(s[i].key), s[i].value);
+	}
+
+public:
+	explicit HashTable(ResizeMode resize = RESIZE_AT_ONCE) : HashTable(resize, Hash()) {}
+
+	// Empty table with the given hash and equality, e.g. a seeded hash
+	HashTable(ResizeMode resize, const Hash& hash, const Eq& eq = Eq())
+		: ctrl(nullptr), slots(nullptr), cap(0), count(0), growthLeft(0), hasher(hash), equal(eq), mode(resize),
+		  oldCtrl(nullptr), oldSlots(nullptr), oldCap(0), migrateNext(0) {}
+
+	HashTable(const HashTable& other) : HashTable(other.mode, other.hasher, other.equal) {
+		reserve(other.count);
+		other.for_each([this](const K& k, const V& v) { insert(k, v); });
+	}
+
+	HashTable(HashTable&& other) noexcept : HashTable() {
+		swap(other);
+	}
+
+	~HashTable() {
+		clear();
+		deallocate(ctrl, slots, cap);
+	}
+
+	HashTable& operator=(const HashTable& other) {
+		if (this != &other) {
+			HashTable copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	HashTable& operator=(HashTable&& other) noexcept {
+		if (this != &other) {
+			clear();
+			deallocate(ctrl, slots, cap);
+			growthLeft = 0;
+			swap(other);
+		}
+		return *this;
+	}
+
+	void swap(HashTable& other) noexcept {
+		std::swap(ctrl, other.ctrl);
+		std::swap(slots, other.slots);
+		std::swap(cap, other.cap);
+		std::swap(count, other.count);
+		std::swap(growthLeft, other.growthLeft);
+		std::swap(hasher, other.hasher);
+		std::swap(equal, other.equal);
+		std::swap(mode, other.mode);
+		std::swap(oldCtrl, other.oldCtrl);
+		std::swap(oldSlots, other.oldSlots);
+		std::swap(oldCap, other.oldCap);
+		std::swap(migrateNext, other.migrateNext);
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	size_t capacity() const { return cap; }
+	double loadFactor() const { return cap ? double(count) / double(cap) : 0.0; }
+	ResizeMode resizeMode() const { return mode; }
+
+	// True while an incremental resize still holds entries in the old arrays
+	bool isMigrating() const { return oldCap != 0; }
+
+	// Makes room for n entries without further rehashing
+	void reserve(size_t n) {
+		size_t capacity = MIN_CAPACITY;
+		while (maxLoad(capacity) < n)
+			capacity *= 2;
+		if (capacity > cap)
+			rehash(capacity);
+	}
+
+	// Removes all entries, keeping the current slot arrays
+	void clear() {
+		destroyAll(oldCtrl, oldSlots, oldCap);
+		deallocate(oldCtrl, oldSlots, oldCap);
+		if (cap == 0)
+			return;
+		destroyAll(ctrl, slots, cap);
+		std::memset(ctrl, EMPTY, cap);
+		count = 0;
+		growthLeft = maxLoad(cap);
+	}
+
+	V* find(const K& key) {
+		Slot* s = findSlot(key);
+		return s ? &s->value : nullptr;
+	}
+
+	const V* find(const K& key) const {
+		Slot* s = findSlot(key);
+		return s ? &s->value : nullptr;
+	}
+
+	template <class Q>
+		requires TRANSPARENT
+	V* find(const Q& key) {
+		Slot* s = findSlot(key);
+		return s ? &s->value : nullptr;
+	}
+
+	template <class Q>
+		requires TRANSPARENT
+	const V* find(const Q& key) const {
+		Slot* s = findSlot(key);
+		return s ? &s->value : nullptr;
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		if (findSlot(key))
+			return false;
+		migrateStep();
+		reserveOne();
+		place(Slot{ key, value }, hasher(key));
+		++count;
+		return true;
+	}
+
+	bool erase(const K& key) {
+		Slot* s = findSlot(key);
+		if (!s)
+			return false;
+		eraseSlot(s);
+		migrateStep();
+		return true;
+	}
+
+	template <class Q>
+		requires TRANSPARENT
+	bool erase(const Q& key) {
+		Slot* s = findSlot(key);
+		if (!s)
+			return false;
+		eraseSlot(s);
+		migrateStep();
+		return true;
+	}
+
+	// f(key, value) for every entry, in slot order
+	template <class F>
+	void for_each(F f) const {
+		auto g = [&f](const K& k, V& v) { f(k, static_cast<const V&>(v)); };
+		visit(ctrl, slots, cap, g);
+		visit(oldCtrl, oldSlots, oldCap, g);
+	}
+
+	template <class F>
+	void for_each(F f) {
+		visit(ctrl, slots, cap, f);
+		visit(oldCtrl, oldSlots, oldCap, f);
+	}
+};
+
+#endif
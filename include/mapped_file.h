@@ -0,0 +1,141 @@
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Whole file mapped read-only into memory. Opening costs a few system
+// calls whatever the file size; pages are read in by the OS on first
+// touch and shared with every other process mapping the same file.
+class MappedFile {
+	const uint8_t* base;
+	size_t length;
+#if defined(_WIN32)
+	HANDLE file;
+	HANDLE mapping;
+#endif
+
+	void release() noexcept {
+#if defined(_WIN32)
+		if (base)
+			UnmapViewOfFile(base);
+		if (mapping)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (base)
+			munmap(const_cast<uint8_t*>(base), length);
+#endif
+		base = nullptr;
+		length = 0;
+	}
+
+public:
+#if defined(_WIN32)
+	MappedFile() : base(nullptr), length(0), file(INVALID_HANDLE_VALUE), mapping(nullptr) {}
+#else
+	MappedFile() : base(nullptr), length(0) {}
+#endif
+
+	explicit MappedFile(const std::string& path) : MappedFile() {
+		open(path);
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept : MappedFile() {
+		swap(other);
+	}
+
+	MappedFile& operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			release();
+			swap(other);
+		}
+		return *this;
+	}
+
+	~MappedFile() {
+		release();
+	}
+
+	void swap(MappedFile& other) noexcept {
+		std::swap(base, other.base);
+		std::swap(length, other.length);
+#if defined(_WIN32)
+		std::swap(file, other.file);
+		std::swap(mapping, other.mapping);
+#endif
+	}
+
+	// Maps the file, replacing any current mapping; an empty file maps to
+	// no data
+	void open(const std::string& path) {
+		release();
+#if defined(_WIN32)
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("Can't open " + path);
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize)) {
+			release();
+			throw std::runtime_error("Can't get the size of " + path);
+		}
+		if (fileSize.QuadPart == 0)
+			return;
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+			base = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!base) {
+			release();
+			throw std::runtime_error("Can't map " + path);
+		}
+		length = size_t(fileSize.QuadPart);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw std::runtime_error("Can't open " + path);
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			::close(fd);
+			throw std::runtime_error("Can't get the size of " + path);
+		}
+		if (st.st_size > 0) {
+			void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+			if (p == MAP_FAILED) {
+				::close(fd);
+				throw std::runtime_error("Can't map " + path);
+			}
+			base = static_cast<const uint8_t*>(p);
+			length = size_t(st.st_size);
+		}
+		// the mapping stays valid after the descriptor is closed
+		::close(fd);
+#endif
+	}
+
+	const uint8_t* data() const { return base; }
+	size_t size() const { return length; }
+	bool isOpen() const { return base != nullptr; }
+};
+
+#endif
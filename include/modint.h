@@ -0,0 +1,173 @@
+#ifndef __MODINT_H__
+#define __MODINT_H__
+
+#include <concepts>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include "coefficient.h"
+
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+// Full 64 x 64 -> 128-bit product split into halves
+inline void mulWide(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+	hi = static_cast<uint64_t>(p >> 64);
+	lo = static_cast<uint64_t>(p);
+#else
+	lo = _umul128(a, b, &hi);
+#endif
+}
+
+// Integer modulo an odd Mod < 2^63 held in Montgomery form a * 2^64 mod Mod.
+// A product then needs one wide multiply for the operands and one for the
+// reduction, with no division: REDC(T) = (T - m * Mod) / 2^64 where
+// m = T * Mod^-1 mod 2^64 makes the low halves cancel exactly. Division and
+// inverse use Fermat's little theorem, so they require Mod to be prime.
+template <uint64_t Mod>
+class MontgomeryInt {
+	static_assert(Mod % 2 == 1 && Mod < (uint64_t(1) << 63), "Modulus must be odd and below 2^63");
+
+	// Mod^-1 mod 2^64 by Newton's iteration, each step doubles the correct bits
+	static constexpr uint64_t computeInverse() {
+		uint64_t inv = Mod; // correct to 3 bits for any odd Mod
+		for (int i = 0; i < 5; ++i)
+			inv *= 2 - Mod * inv;
+		return inv;
+	}
+
+	// 2^128 mod Mod by doubling 2^64 mod Mod, no 128-bit arithmetic needed
+	static constexpr uint64_t computeR2() {
+		uint64_t r = (0 - Mod) % Mod;
+		for (int i = 0; i < 64; ++i) {
+			r <<= 1;
+			if (r >= Mod)
+				r -= Mod;
+		}
+		return r;
+	}
+
+	static constexpr uint64_t INV = computeInverse();
+	static constexpr uint64_t R2 = computeR2();
+
+	uint64_t v;
+
+	// (hi * 2^64 + lo) / 2^64 mod Mod for hi < Mod
+	static uint64_t reduce(uint64_t hi, uint64_t lo) {
+		uint64_t mh, ml;
+		mulWide(lo * INV, Mod, mh, ml);
+		return hi >= mh ? hi - mh : hi - mh + Mod;
+	}
+
+	static uint64_t mulReduce(uint64_t a, uint64_t b) {
+		uint64_t hi, lo;
+		mulWide(a, b, hi, lo);
+		return reduce(hi, lo);
+	}
+
+	static MontgomeryInt fromRaw(uint64_t raw) {
+		MontgomeryInt res;
+		res.v = raw;
+		return res;
+	}
+
+public:
+	static constexpr uint64_t MODULUS = Mod;
+
+	MontgomeryInt() : v(0) {}
+
+	template <std::integral I>
+	MontgomeryInt(I x) {
+		uint64_t r;
+		if constexpr (std::is_signed_v<I>) {
+			// |x| computed without overflowing on the most negative value
+			uint64_t mag = x < 0 ? uint64_t(-(x + 1)) + 1 : uint64_t(x);
+			r = mag % Mod;
+			if (x < 0 && r != 0)
+				r = Mod - r;
+		}
+		else {
+			r = uint64_t(x) % Mod;
+		}
+		v = mulReduce(r, R2);
+	}
+
+	// Canonical representative in [0, Mod)
+	uint64_t value() const { return reduce(0, v); }
+
+	MontgomeryInt operator+(const MontgomeryInt& o) const {
+		uint64_t s = v + o.v;
+		return fromRaw(s >= Mod ? s - Mod : s);
+	}
+
+	MontgomeryInt operator-(const MontgomeryInt& o) const {
+		return fromRaw(v >= o.v ? v - o.v : v - o.v + Mod);
+	}
+
+	MontgomeryInt operator-() const { return fromRaw(v ? Mod - v : 0); }
+
+	MontgomeryInt operator*(const MontgomeryInt& o) const { return fromRaw(mulReduce(v, o.v)); }
+
+	MontgomeryInt pow(uint64_t e) const {
+		MontgomeryInt res(1), base(*this);
+		while (e) {
+			if (e & 1)
+				res *= base;
+			base *= base;
+			e >>= 1;
+		}
+		return res;
+	}
+
+	MontgomeryInt inverse() const {
+		if (v == 0)
+			throw std::invalid_argument("Division by zero!");
+		return pow(Mod - 2);
+	}
+
+	MontgomeryInt operator/(const MontgomeryInt& o) const { return *this * o.inverse(); }
+
+	MontgomeryInt& operator+=(const MontgomeryInt& o) { return *this = *this + o; }
+	MontgomeryInt& operator-=(const MontgomeryInt& o) { return *this = *this - o; }
+	MontgomeryInt& operator*=(const MontgomeryInt& o) { return *this = *this * o; }
+	MontgomeryInt& operator/=(const MontgomeryInt& o) { return *this = *this / o; }
+
+	// The Montgomery form is a bijection on [0, Mod), so compare it directly
+	bool operator==(const MontgomeryInt& o) const { return v == o.v; }
+	bool operator!=(const MontgomeryInt& o) const { return v != o.v; }
+
+	friend std::ostream& operator<<(std::ostream& ostr, const MontgomeryInt& a) {
+		return ostr << a.value();
+	}
+};
+
+// Coefficients modulo the Mersenne prime 2^61 - 1
+typedef MontgomeryInt<(uint64_t(1) << 61) - 1> ModP61;
+
+// Literals must be non-negative integers the translator reads exactly
+// (below 2^53); exponents are the canonical representatives.
+template <uint64_t Mod>
+struct CoefficientTraits<MontgomeryInt<Mod>> {
+	typedef MontgomeryInt<Mod> Coef;
+
+	static Coef fromNumber(double v) {
+		if (v != std::floor(v) || v >= 9007199254740992.0)
+			throw std::invalid_argument("Modular coefficients must be integers below 2^53");
+		return Coef(static_cast<uint64_t>(v));
+	}
+
+	static Coef power(const Coef& base, const Coef& e) { return base.pow(e.value()); }
+
+	static bool toExponent(const Coef& e, unsigned limit, unsigned& out) {
+		if (e.value() > limit)
+			return false;
+		out = static_cast<unsigned>(e.value());
+		return true;
+	}
+};
+
+#endif
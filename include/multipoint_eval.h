@@ -0,0 +1,149 @@
+#ifndef __MULTIPOINT_EVAL_H__
+#define __MULTIPOINT_EVAL_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// Kernels for evaluating one polynomial at many points. Points are processed
+// in fixed-size blocks and the innermost loops run across the points of a
+// block with no dependency between iterations, so the compiler turns them
+// into SIMD code (one lane per point).
+class MultiPointEval {
+public:
+	enum Scheme {
+		HORNER, // n dependent multiply-adds per point, fewest operations
+		ESTRIN  // pairs coefficients level by level: more operations, but
+		        // independent ones, which pays off on high degrees
+	};
+
+	static constexpr size_t BLOCK = 64;
+
+	static void checkSizes(size_t in, size_t out) {
+		if (in != out)
+			throw std::invalid_argument("Input and output spans must have the same size");
+	}
+
+	// out[p] = sum coefs[i] * xs[p]^i, coefs in ascending order of degree
+	static void dense(const std::vector<double>& coefs, std::span<const double> xs, std::span<double> out,
+		Scheme scheme = HORNER) {
+		checkSizes(xs.size(), out.size());
+		if (coefs.empty()) {
+			std::fill(out.begin(), out.end(), 0.0);
+			return;
+		}
+
+		std::vector<double> scratch;
+		for (size_t start = 0; start < xs.size(); start += BLOCK) {
+			size_t count = std::min(BLOCK, xs.size() - start);
+			if (scheme == ESTRIN)
+				estrinBlock(coefs, xs.data() + start, out.data() + start, count, scratch);
+			else
+				hornerBlock(coefs, xs.data() + start, out.data() + start, count);
+		}
+	}
+
+	// Horner over one block of points, the accumulators stay in registers/L1
+	static void hornerBlock(const std::vector<double>& coefs, const double* x, double* out, size_t count) {
+		double acc[BLOCK];
+		double top = coefs.back();
+		for (size_t p = 0; p < count; ++p)
+			acc[p] = top;
+
+		for (size_t i = coefs.size() - 1; i-- > 0;) {
+			double c = coefs[i];
+			for (size_t p = 0; p < count; ++p)
+				acc[p] = acc[p] * x[p] + c;
+		}
+
+		std::copy(acc, acc + count, out);
+	}
+
+	// Level 0 pairs up c[2k] + c[2k+1]*x, every next level pairs up the
+	// previous one with x^2, x^4, ... until one value per point remains
+	static void estrinBlock(const std::vector<double>& coefs, const double* x, double* out, size_t count,
+		std::vector<double>& scratch) {
+		size_t n = coefs.size();
+		size_t width = (n + 1) / 2;
+		scratch.resize(width * BLOCK);
+		double* level = scratch.data();
+
+		double power[BLOCK];
+		for (size_t p = 0; p < count; ++p)
+			power[p] = x[p];
+
+		for (size_t k = 0; k < width; ++k) {
+			double c0 = coefs[2 * k];
+			double c1 = 2 * k + 1 < n ? coefs[2 * k + 1] : 0.0;
+			double* dst = level + k * BLOCK;
+			for (size_t p = 0; p < count; ++p)
+				dst[p] = c0 + c1 * power[p];
+		}
+
+		while (width > 1) {
+			for (size_t p = 0; p < count; ++p)
+				power[p] *= power[p];
+
+			size_t next = (width + 1) / 2;
+			for (size_t k = 0; k < next; ++k) {
+				const double* lo = level + 2 * k * BLOCK;
+				double* dst = level + k * BLOCK;
+				if (2 * k + 1 < width) {
+					const double* hi = level + (2 * k + 1) * BLOCK;
+					for (size_t p = 0; p < count; ++p)
+						dst[p] = lo[p] + hi[p] * power[p];
+				}
+				else if (dst != lo) {
+					std::copy(lo, lo + count, dst);
+				}
+			}
+			width = next;
+		}
+
+		std::copy(level, level + count, out);
+	}
+
+	// Powers of one variable for a block of points, restricted to the distinct
+	// exponents a polynomial actually uses (sorted ascending). Consecutive
+	// exponents are reached by multiplying with base^gap, where the gap is the
+	// same for every point, so the table is built with vector operations.
+	static void powerTable(const std::vector<unsigned>& exponents, const double* base, size_t count,
+		std::vector<double>& table) {
+		table.resize(exponents.size() * BLOCK);
+		double run[BLOCK], step[BLOCK], sq[BLOCK];
+		for (size_t p = 0; p < count; ++p)
+			run[p] = 1.0;
+
+		unsigned prev = 0;
+		for (size_t k = 0; k < exponents.size(); ++k) {
+			unsigned gap = exponents[k] - prev;
+			prev = exponents[k];
+
+			if (gap == 1) {
+				for (size_t p = 0; p < count; ++p)
+					run[p] *= base[p];
+			}
+			else if (gap > 1) {
+				for (size_t p = 0; p < count; ++p) {
+					step[p] = 1.0;
+					sq[p] = base[p];
+				}
+				for (; gap; gap >>= 1) {
+					if (gap & 1)
+						for (size_t p = 0; p < count; ++p)
+							step[p] *= sq[p];
+					for (size_t p = 0; p < count; ++p)
+						sq[p] *= sq[p];
+				}
+				for (size_t p = 0; p < count; ++p)
+					run[p] *= step[p];
+			}
+
+			std::copy(run, run + count, table.data() + k * BLOCK);
+		}
+	}
+};
+
+#endif
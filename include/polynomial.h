@@ -0,0 +1,695 @@
+#ifndef __POLYNOMIAL_H__
+#define __POLYNOMIAL_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "coefficient.h"
+#include "cow_vector.h"
+#include "multipoint_eval.h"
+
+// Monomial coef * x^a * y^b * z^c. The exponents are packed into one 64-bit
+// key, 21 bits per variable with x in the high bits, so monomials compare as
+// integers (lexicographic order x > y > z) and multiply by adding keys.
+// The top bit of every field is a guard: it is set only when a sum of two
+// exponents exceeds MAX_EXP, which is how overflow is detected.
+template <class Coef>
+struct BasicMonomial {
+	typedef uint64_t Key;
+
+	static constexpr int FIELD_BITS = 21;
+	static constexpr unsigned MAX_EXP = (1u << (FIELD_BITS - 1)) - 1;
+	static constexpr Key FIELD_MASK = (Key(1) << FIELD_BITS) - 1;
+	static constexpr Key GUARD_MASK = (Key(1) << (FIELD_BITS - 1)) * ((Key(1) << 2 * FIELD_BITS) + (Key(1) << FIELD_BITS) + 1);
+
+	Key key;
+	Coef coef;
+
+	BasicMonomial() : key(0), coef() {}
+	BasicMonomial(Coef c, Key k) : key(k), coef(c) {}
+	BasicMonomial(Coef c, unsigned x, unsigned y, unsigned z) : key(pack(x, y, z)), coef(c) {}
+
+	static Key pack(unsigned x, unsigned y, unsigned z) {
+		if (x > MAX_EXP || y > MAX_EXP || z > MAX_EXP)
+			throw std::overflow_error("Monomial exponent is too large");
+		return (Key(x) << 2 * FIELD_BITS) | (Key(y) << FIELD_BITS) | Key(z);
+	}
+
+	// Key of the product of two monomials
+	static Key mulKeys(Key a, Key b) {
+		Key sum = a + b;
+		if (sum & GUARD_MASK)
+			throw std::overflow_error("Monomial exponent is too large");
+		return sum;
+	}
+
+	unsigned degX() const { return unsigned(key >> 2 * FIELD_BITS); }
+	unsigned degY() const { return unsigned((key >> FIELD_BITS) & FIELD_MASK); }
+	unsigned degZ() const { return unsigned(key & FIELD_MASK); }
+	unsigned degree() const { return degX() + degY() + degZ(); }
+
+	bool operator==(const BasicMonomial& other) const { return key == other.key && coef == other.coef; }
+	bool operator!=(const BasicMonomial& other) const { return !(*this == other); }
+};
+
+typedef BasicMonomial<double> Monomial;
+
+// Sparse polynomial in x, y, z. Terms live in a flat vector sorted by key in
+// descending order, with like terms combined and zero coefficients dropped,
+// so equal polynomials always have identical term vectors. The vector is
+// copy-on-write: copies of a polynomial share it until one of them changes.
+// Coef is double for the translator, or any type with ring arithmetic and
+// == such as MontgomeryInt from modint.h; Coef() must be zero.
+template <class Coef>
+class BasicPolynomial {
+public:
+	typedef BasicMonomial<Coef> Monomial;
+	typedef BasicPolynomial Polynomial;
+	typedef typename Monomial::Key Key;
+
+	enum MulMethod { MUL_AUTO, MUL_SCHOOLBOOK, MUL_HEAP, MUL_HASH };
+
+private:
+	CowVector<Monomial> terms;
+
+	static bool keyGreater(const Monomial& a, const Monomial& b) { return a.key > b.key; }
+
+	// Takes over a term vector that is already in canonical form
+	static Polynomial adopt(std::vector<Monomial>&& sorted) {
+		Polynomial res;
+		res.terms = CowVector<Monomial>(std::move(sorted));
+		return res;
+	}
+
+	// Sorts terms, combines like terms and drops zeros
+	static void normalize(std::vector<Monomial>& t) {
+		std::sort(t.begin(), t.end(), keyGreater);
+
+		size_t out = 0;
+		for (size_t i = 0; i < t.size();) {
+			Monomial m = t[i];
+			for (++i; i < t.size() && t[i].key == m.key; ++i)
+				m.coef += t[i].coef;
+			if (m.coef != Coef())
+				t[out++] = m;
+		}
+		t.resize(out);
+	}
+
+	// Linear merge of two sorted term vectors, b negated if asked
+	static Polynomial merge(const Polynomial& a, const Polynomial& b, bool negate) {
+		if (b.isZero())
+			return a;
+		if (a.isZero() && !negate)
+			return b;
+
+		const std::vector<Monomial>& ta = a.terms.view();
+		const std::vector<Monomial>& tb = b.terms.view();
+		std::vector<Monomial> res;
+		res.reserve(ta.size() + tb.size());
+
+		size_t i = 0, j = 0;
+		while (i < ta.size() && j < tb.size()) {
+			if (ta[i].key > tb[j].key)
+				res.push_back(ta[i++]);
+			else if (ta[i].key < tb[j].key) {
+				res.push_back(Monomial(negate ? -tb[j].coef : tb[j].coef, tb[j].key));
+				++j;
+			}
+			else {
+				Coef c = negate ? ta[i].coef - tb[j].coef : ta[i].coef + tb[j].coef;
+				if (c != Coef())
+					res.push_back(Monomial(c, ta[i].key));
+				++i;
+				++j;
+			}
+		}
+		for (; i < ta.size(); ++i)
+			res.push_back(ta[i]);
+		for (; j < tb.size(); ++j)
+			res.push_back(Monomial(negate ? -tb[j].coef : tb[j].coef, tb[j].key));
+
+		return adopt(std::move(res));
+	}
+
+	static constexpr size_t SCHOOLBOOK_MAX_PRODUCTS = 256;
+	// hash accumulation pays off once every result term gets this many products
+	static constexpr size_t HASH_MIN_COLLISIONS = 4;
+
+	// Any overflowing product would involve the largest exponents of both
+	// factors, so one check up front makes the per-product checks unnecessary
+	static void checkProductDegrees(const Polynomial& a, const Polynomial& b) {
+		unsigned ma[3] = { 0, 0, 0 }, mb[3] = { 0, 0, 0 };
+		a.maxExponents(ma);
+		b.maxExponents(mb);
+		for (int v = 0; v < 3; ++v)
+			if (ma[v] + mb[v] > Monomial::MAX_EXP)
+				throw std::overflow_error("Monomial exponent is too large");
+	}
+
+	void maxExponents(unsigned exps[3]) const {
+		for (size_t i = 0; i < terms.size(); ++i) {
+			exps[0] = std::max(exps[0], terms[i].degX());
+			exps[1] = std::max(exps[1], terms[i].degY());
+			exps[2] = std::max(exps[2], terms[i].degZ());
+		}
+	}
+
+	static MulMethod chooseMulMethod(const Polynomial& small, const Polynomial& large) {
+		double products = double(small.size()) * double(large.size());
+		if (products <= SCHOOLBOOK_MAX_PRODUCTS)
+			return MUL_SCHOOLBOOK;
+
+		// distinct result keys can't exceed the exponent box of the product
+		unsigned ma[3] = { 0, 0, 0 }, mb[3] = { 0, 0, 0 };
+		small.maxExponents(ma);
+		large.maxExponents(mb);
+		double box = 1;
+		for (int v = 0; v < 3; ++v)
+			box *= double(ma[v]) + mb[v] + 1;
+
+		return box * HASH_MIN_COLLISIONS <= products ? MUL_HASH : MUL_HEAP;
+	}
+
+	static Polynomial mulSchoolbook(const Polynomial& a, const Polynomial& b) {
+		const std::vector<Monomial>& ta = a.terms.view();
+		const std::vector<Monomial>& tb = b.terms.view();
+		std::vector<Monomial> res;
+		res.reserve(ta.size() * tb.size());
+		for (size_t i = 0; i < ta.size(); ++i)
+			for (size_t j = 0; j < tb.size(); ++j)
+				res.push_back(Monomial(ta[i].coef * tb[j].coef, ta[i].key + tb[j].key));
+		normalize(res);
+		return adopt(std::move(res));
+	}
+
+	struct HeapEntry {
+		Key key;
+		uint32_t i, j;
+	};
+
+	// Restores the max-heap property below position pos
+	static void siftDown(std::vector<HeapEntry>& heap, size_t pos) {
+		size_t n = heap.size();
+		HeapEntry e = heap[pos];
+		for (size_t child = 2 * pos + 1; child < n; child = 2 * pos + 1) {
+			if (child + 1 < n && heap[child + 1].key > heap[child].key)
+				++child;
+			if (heap[child].key <= e.key)
+				break;
+			heap[pos] = heap[child];
+			pos = child;
+		}
+		heap[pos] = e;
+	}
+
+	static void siftUp(std::vector<HeapEntry>& heap, size_t pos) {
+		HeapEntry e = heap[pos];
+		while (pos > 0 && heap[(pos - 1) / 2].key < e.key) {
+			heap[pos] = heap[(pos - 1) / 2];
+			pos = (pos - 1) / 2;
+		}
+		heap[pos] = e;
+	}
+
+	// Stream i yields a[i] * b[0], a[i] * b[1], ... in descending order. Stream
+	// i + 1 is only entered once a[i] * b[0] is popped, since everything it
+	// holds is smaller, which keeps the heap small (Monagan-Pearce). The next
+	// product of a stream replaces the popped top in place, so most steps cost
+	// a single sift-down.
+	static Polynomial mulHeap(const Polynomial& a, const Polynomial& b) {
+		const std::vector<Monomial>& ta = a.terms.view();
+		const std::vector<Monomial>& tb = b.terms.view();
+		std::vector<Monomial> res;
+		std::vector<HeapEntry> heap;
+		heap.reserve(ta.size());
+
+		HeapEntry start = { ta[0].key + tb[0].key, 0, 0 };
+		heap.push_back(start);
+
+		while (!heap.empty()) {
+			Key key = heap.front().key;
+			Coef coef = Coef();
+
+			do {
+				HeapEntry e = heap.front();
+				coef += ta[e.i].coef * tb[e.j].coef;
+
+				if (e.j + 1 < tb.size()) {
+					heap.front().key = ta[e.i].key + tb[e.j + 1].key;
+					heap.front().j = e.j + 1;
+				}
+				else {
+					heap.front() = heap.back();
+					heap.pop_back();
+				}
+				if (!heap.empty())
+					siftDown(heap, 0);
+
+				if (e.j == 0 && e.i + 1 < ta.size()) {
+					HeapEntry next = { ta[e.i + 1].key + tb[0].key, e.i + 1, 0 };
+					heap.push_back(next);
+					siftUp(heap, heap.size() - 1);
+				}
+			} while (!heap.empty() && heap.front().key == key);
+
+			if (coef != Coef())
+				res.push_back(Monomial(coef, key));
+		}
+		return adopt(std::move(res));
+	}
+
+	// k-way merge of sorted term vectors: heap entry i is the next unread
+	// term j of source i, the top is replaced in place as its source advances
+	static Polynomial mergeAll(const std::vector<const std::vector<Monomial>*>& sources) {
+		std::vector<Monomial> res;
+		std::vector<HeapEntry> heap;
+		heap.reserve(sources.size());
+		size_t total = 0;
+
+		for (size_t i = 0; i < sources.size(); ++i) {
+			total += sources[i]->size();
+			if (!sources[i]->empty()) {
+				HeapEntry e = { (*sources[i])[0].key, uint32_t(i), 0 };
+				heap.push_back(e);
+				siftUp(heap, heap.size() - 1);
+			}
+		}
+		res.reserve(total);
+
+		while (!heap.empty()) {
+			Key key = heap.front().key;
+			Coef coef = Coef();
+
+			do {
+				HeapEntry& top = heap.front();
+				const std::vector<Monomial>& src = *sources[top.i];
+				coef += src[top.j].coef;
+
+				if (top.j + 1 < src.size()) {
+					top.j++;
+					top.key = src[top.j].key;
+				}
+				else {
+					heap.front() = heap.back();
+					heap.pop_back();
+				}
+				if (!heap.empty())
+					siftDown(heap, 0);
+			} while (!heap.empty() && heap.front().key == key);
+
+			if (coef != Coef())
+				res.push_back(Monomial(coef, key));
+		}
+		return adopt(std::move(res));
+	}
+
+	static Polynomial mulHash(const Polynomial& a, const Polynomial& b) {
+		// no valid key has guard bits set, so all-ones marks an empty slot
+		const Key EMPTY = ~Key(0);
+
+		size_t capacity = 1024;
+		size_t used = 0;
+		std::vector<Monomial> table(capacity, Monomial(Coef(), EMPTY));
+
+		const std::vector<Monomial>& ta = a.terms.view();
+		const std::vector<Monomial>& tb = b.terms.view();
+		for (size_t i = 0; i < ta.size(); ++i) {
+			const Monomial& ma = ta[i];
+			for (size_t j = 0; j < tb.size(); ++j) {
+				Key key = ma.key + tb[j].key;
+				Coef coef = ma.coef * tb[j].coef;
+
+				size_t mask = capacity - 1;
+				size_t slot = size_t((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+				while (table[slot].key != key && table[slot].key != EMPTY)
+					slot = (slot + 1) & mask;
+
+				if (table[slot].key == key) {
+					table[slot].coef += coef;
+					continue;
+				}
+				table[slot] = Monomial(coef, key);
+
+				// keep the load factor under 1/2
+				if (++used * 2 > capacity) {
+					std::vector<Monomial> old(capacity * 2, Monomial(Coef(), EMPTY));
+					old.swap(table);
+					capacity *= 2;
+					mask = capacity - 1;
+					for (size_t k = 0; k < old.size(); ++k) {
+						if (old[k].key == EMPTY)
+							continue;
+						size_t s = size_t((old[k].key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+						while (table[s].key != EMPTY)
+							s = (s + 1) & mask;
+						table[s] = old[k];
+					}
+				}
+			}
+		}
+
+		std::vector<Monomial> res;
+		res.reserve(used);
+		for (size_t k = 0; k < table.size(); ++k)
+			if (table[k].key != EMPTY && table[k].coef != Coef())
+				res.push_back(table[k]);
+		std::sort(res.begin(), res.end(), keyGreater);
+		return adopt(std::move(res));
+	}
+
+public:
+	// x^e by repeated squaring
+	template <class T>
+	static T ipow(T x, unsigned e) {
+		T res(1);
+		while (e) {
+			if (e & 1)
+				res *= x;
+			x *= x;
+			e >>= 1;
+		}
+		return res;
+	}
+
+	BasicPolynomial() {}
+	BasicPolynomial(Coef c) {
+		if (c != Coef())
+			terms = CowVector<Monomial>(std::vector<Monomial>(1, Monomial(c, Key(0))));
+	}
+	explicit BasicPolynomial(std::vector<Monomial> monomials) {
+		normalize(monomials);
+		terms = CowVector<Monomial>(std::move(monomials));
+	}
+
+	// Single monomial c * x^ex * y^ey * z^ez
+	static Polynomial monomial(Coef c, unsigned ex, unsigned ey, unsigned ez) {
+		Monomial m(c, ex, ey, ez);
+		return c != Coef() ? adopt(std::vector<Monomial>(1, m)) : Polynomial();
+	}
+
+	// Adds c * x^ex * y^ey * z^ez to the polynomial
+	void addTerm(Coef c, unsigned ex, unsigned ey, unsigned ez) {
+		Monomial m(c, ex, ey, ez);
+		typename std::vector<Monomial>::const_iterator found = std::lower_bound(terms.begin(), terms.end(), m, keyGreater);
+		size_t pos = size_t(found - terms.begin());
+		bool same = found != terms.end() && found->key == m.key;
+		if (!same && c == Coef())
+			return;
+
+		std::vector<Monomial>& t = terms.edit();
+		if (same) {
+			t[pos].coef += c;
+			if (t[pos].coef == Coef())
+				t.erase(t.begin() + pos);
+		}
+		else {
+			t.insert(t.begin() + pos, m);
+		}
+	}
+
+	// True if both polynomials share one term vector (a copy not yet modified)
+	bool sharesStorageWith(const Polynomial& other) const { return terms.sharesWith(other.terms); }
+
+	Coef coefficient(unsigned ex, unsigned ey, unsigned ez) const {
+		Monomial m(Coef(), ex, ey, ez);
+		typename std::vector<Monomial>::const_iterator it = std::lower_bound(terms.begin(), terms.end(), m, keyGreater);
+		return (it != terms.end() && it->key == m.key) ? it->coef : Coef();
+	}
+
+	const std::vector<Monomial>& monomials() const { return terms.view(); }
+	size_t size() const { return terms.size(); }
+	bool isZero() const { return terms.empty(); }
+	bool isConstant() const { return terms.empty() || (terms.size() == 1 && terms[0].key == 0); }
+
+	// Total degree, -1 for the zero polynomial
+	int degree() const {
+		int deg = -1;
+		for (size_t i = 0; i < terms.size(); ++i)
+			deg = std::max(deg, int(terms[i].degree()));
+		return deg;
+	}
+
+	Coef evaluate(Coef x, Coef y = Coef(), Coef z = Coef()) const {
+		Coef sum = Coef();
+		for (size_t i = 0; i < terms.size(); ++i) {
+			const Monomial& m = terms[i];
+			sum += m.coef * ipow(x, m.degX()) * ipow(y, m.degY()) * ipow(z, m.degZ());
+		}
+		return sum;
+	}
+
+	// Evaluation of a polynomial in x only at many points. Polynomials that are
+	// dense enough go through blocked Horner (or Estrin) on the coefficient
+	// vector, very sparse ones through the power-table path below.
+	void evaluate(std::span<const double> xs, std::span<double> out,
+		MultiPointEval::Scheme scheme = MultiPointEval::HORNER) const
+		requires std::is_same_v<Coef, double> {
+		MultiPointEval::checkSizes(xs.size(), out.size());
+		for (size_t i = 0; i < terms.size(); ++i)
+			if (terms[i].degY() != 0 || terms[i].degZ() != 0)
+				throw std::invalid_argument("Polynomial depends on y or z");
+
+		size_t deg = terms.empty() ? 0 : terms[0].degX();
+		if (deg + 1 > 4 * terms.size()) {
+			evaluate(xs, std::span<const double>(), std::span<const double>(), out);
+			return;
+		}
+
+		std::vector<double> coefs(deg + 1, 0.0);
+		for (size_t i = 0; i < terms.size(); ++i)
+			coefs[terms[i].degX()] = terms[i].coef;
+		MultiPointEval::dense(coefs, xs, out, scheme);
+	}
+
+	// Evaluation at points (xs[p], ys[p], zs[p]). For every block of points
+	// the powers of each variable are tabulated once for the distinct
+	// exponents in use, then each term is one vectorized multiply-add over the
+	// block. A span may be empty if its variable does not occur.
+	void evaluate(std::span<const double> xs, std::span<const double> ys, std::span<const double> zs,
+		std::span<double> out) const
+		requires std::is_same_v<Coef, double> {
+		const size_t BLOCK = MultiPointEval::BLOCK;
+		std::span<const double> vars[3] = { xs, ys, zs };
+		std::vector<unsigned> exps[3];
+		std::vector<uint32_t> index[3];
+
+		for (int v = 0; v < 3; ++v) {
+			for (size_t i = 0; i < terms.size(); ++i)
+				exps[v].push_back(v == 0 ? terms[i].degX() : v == 1 ? terms[i].degY() : terms[i].degZ());
+			index[v] = std::vector<uint32_t>(exps[v].begin(), exps[v].end());
+
+			std::sort(exps[v].begin(), exps[v].end());
+			exps[v].erase(std::unique(exps[v].begin(), exps[v].end()), exps[v].end());
+			for (size_t i = 0; i < index[v].size(); ++i)
+				index[v][i] = uint32_t(std::lower_bound(exps[v].begin(), exps[v].end(), index[v][i]) - exps[v].begin());
+
+			if (vars[v].empty()) {
+				if (!exps[v].empty() && exps[v].back() != 0)
+					throw std::invalid_argument("No points given for a variable of the polynomial");
+			}
+			else {
+				MultiPointEval::checkSizes(vars[v].size(), out.size());
+			}
+		}
+
+		std::vector<double> tables[3];
+		for (size_t start = 0; start < out.size(); start += BLOCK) {
+			size_t count = std::min(BLOCK, out.size() - start);
+			for (int v = 0; v < 3; ++v)
+				MultiPointEval::powerTable(exps[v], vars[v].empty() ? nullptr : vars[v].data() + start, count, tables[v]);
+
+			double acc[MultiPointEval::BLOCK] = {};
+			for (size_t t = 0; t < terms.size(); ++t) {
+				const double c = terms[t].coef;
+				const double* px = tables[0].data() + index[0][t] * BLOCK;
+				const double* py = tables[1].data() + index[1][t] * BLOCK;
+				const double* pz = tables[2].data() + index[2][t] * BLOCK;
+				for (size_t p = 0; p < count; ++p)
+					acc[p] += c * px[p] * py[p] * pz[p];
+			}
+			std::copy(acc, acc + count, out.data() + start);
+		}
+	}
+
+	// Sum of many polynomials in one k-way merge of their sorted terms:
+	// O(N log k) for N terms in total instead of k - 1 pairwise additions.
+	// With threads > 1 the range is split into chunks merged concurrently,
+	// and the partial sums are then added up pairwise as a tree.
+	template <class It>
+	static Polynomial sum(It first, It last, unsigned threads = 1) {
+		std::vector<const std::vector<Monomial>*> sources;
+		for (; first != last; ++first)
+			sources.push_back(&static_cast<const Polynomial&>(*first).terms.view());
+
+		if (threads <= 1 || sources.size() < 2 * size_t(threads))
+			return mergeAll(sources);
+
+		std::vector<Polynomial> partial(threads);
+		std::vector<std::thread> workers;
+		size_t chunk = (sources.size() + threads - 1) / threads;
+		for (unsigned t = 0; t < threads; ++t) {
+			size_t from = std::min(sources.size(), t * chunk);
+			size_t to = std::min(sources.size(), from + chunk);
+			workers.push_back(std::thread([&sources, &partial, t, from, to] {
+				std::vector<const std::vector<Monomial>*> part(sources.begin() + from, sources.begin() + to);
+				partial[t] = mergeAll(part);
+			}));
+		}
+		for (size_t t = 0; t < workers.size(); ++t)
+			workers[t].join();
+
+		// tree reduction, each level adds disjoint pairs in parallel
+		for (size_t step = 1; step < partial.size(); step *= 2) {
+			workers.clear();
+			for (size_t i = 0; i + step < partial.size(); i += 2 * step)
+				workers.push_back(std::thread([&partial, i, step] {
+					partial[i] = partial[i] + partial[i + step];
+				}));
+			for (size_t t = 0; t < workers.size(); ++t)
+				workers[t].join();
+		}
+		return partial[0];
+	}
+
+	template <class Range>
+	static Polynomial sum(const Range& polynomials, unsigned threads = 1) {
+		return sum(std::begin(polynomials), std::end(polynomials), threads);
+	}
+
+	Polynomial operator+(const Polynomial& other) const { return merge(*this, other, false); }
+	Polynomial operator-(const Polynomial& other) const { return merge(*this, other, true); }
+
+	Polynomial operator-() const {
+		std::vector<Monomial> res(terms.begin(), terms.end());
+		for (size_t i = 0; i < res.size(); ++i)
+			res[i].coef = -res[i].coef;
+		return adopt(std::move(res));
+	}
+
+	Polynomial operator*(const Polynomial& other) const { return multiply(*this, other); }
+
+	// Product a * b with the given strategy:
+	//  - schoolbook: all products, then sort and combine; fine for tiny inputs
+	//  - heap: Johnson's k-way merge of the sorted streams a[i] * b, emits the
+	//    result already sorted with a heap of at most min(n, m) entries
+	//  - hash: accumulates products in an open-addressing table keyed by the
+	//    packed monomial, then sorts the distinct keys; wins when many products
+	//    collide (dense-ish inputs)
+	// Auto picks by size and by the expected number of distinct result terms.
+	static Polynomial multiply(const Polynomial& a, const Polynomial& b, MulMethod method = MUL_AUTO) {
+		const Polynomial& small = a.size() <= b.size() ? a : b;
+		const Polynomial& large = a.size() <= b.size() ? b : a;
+		if (small.isZero())
+			return Polynomial();
+
+		checkProductDegrees(small, large);
+
+		if (method == MUL_AUTO)
+			method = chooseMulMethod(small, large);
+
+		switch (method) {
+		case MUL_SCHOOLBOOK: return mulSchoolbook(small, large);
+		case MUL_HEAP: return mulHeap(small, large);
+		default: return mulHash(small, large);
+		}
+	}
+
+	// this^n by repeated squaring
+	Polynomial pow(unsigned n) const {
+		Polynomial res(Coef(1));
+		Polynomial base(*this);
+		while (n) {
+			if (n & 1)
+				res *= base;
+			n >>= 1;
+			if (n)
+				base *= base;
+		}
+		return res;
+	}
+
+	Polynomial operator*(Coef c) const {
+		if (c == Coef())
+			return Polynomial();
+		if (c == Coef(1))
+			return *this;
+		std::vector<Monomial> res(terms.begin(), terms.end());
+		for (size_t i = 0; i < res.size(); ++i)
+			res[i].coef *= c;
+		return adopt(std::move(res));
+	}
+
+	Polynomial operator/(Coef c) const {
+		if (c == Coef())
+			throw std::invalid_argument("Division by zero!");
+		std::vector<Monomial> res(terms.begin(), terms.end());
+		for (size_t i = 0; i < res.size(); ++i)
+			res[i].coef /= c;
+		return adopt(std::move(res));
+	}
+
+	friend Polynomial operator*(Coef c, const Polynomial& p) { return p * c; }
+
+	Polynomial& operator+=(const Polynomial& other) { return *this = *this + other; }
+	Polynomial& operator-=(const Polynomial& other) { return *this = *this - other; }
+	Polynomial& operator*=(const Polynomial& other) { return *this = *this * other; }
+	Polynomial& operator*=(Coef c) { return *this = *this * c; }
+	Polynomial& operator/=(Coef c) { return *this = *this / c; }
+
+	bool operator==(const Polynomial& other) const { return terms == other.terms; }
+	bool operator!=(const Polynomial& other) const { return !(*this == other); }
+
+	friend std::ostream& operator<<(std::ostream& ostr, const Polynomial& p) {
+		if (p.terms.empty())
+			return ostr << 0;
+
+		static const char names[3] = { 'x', 'y', 'z' };
+		for (size_t i = 0; i < p.terms.size(); ++i) {
+			const Monomial& m = p.terms[i];
+			Coef c = m.coef;
+			if (i > 0) {
+				// unsigned coefficients (residues) always print with " + "
+				bool negative = false;
+				if constexpr (std::is_signed_v<Coef>)
+					negative = c < 0;
+				ostr << (negative ? " - " : " + ");
+				if (negative)
+					c = -c;
+			}
+
+			unsigned exps[3] = { m.degX(), m.degY(), m.degZ() };
+			bool first = true;
+			if (c != Coef(1) || m.key == 0) {
+				if (std::is_signed_v<Coef> && c == Coef(-1) && m.key != 0)
+					ostr << '-';
+				else {
+					ostr << c;
+					first = false;
+				}
+			}
+			for (int v = 0; v < 3; ++v) {
+				if (exps[v] == 0)
+					continue;
+				if (!first)
+					ostr << '*';
+				ostr << names[v];
+				if (exps[v] > 1)
+					ostr << '^' << exps[v];
+				first = false;
+			}
+		}
+		return ostr;
+	}
+};
+
+typedef BasicPolynomial<double> Polynomial;
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Slab allocator for fixed-size blocks (list nodes, tree nodes).
+// Blocks are carved out of contiguous chunks and recycled through an
+// intrusive free list, so neighbouring nodes usually share cache lines.
+// Every thread owns its own pool and takes no lock while its free list
+// lasts. A block may be freed on another thread than the one that made it:
+// it joins the free list of the freeing thread, and once that list holds
+// more than MAX_FREE blocks, BATCH of them move to a depot shared by all
+// threads, where a thread that runs out takes them back before carving a
+// new chunk. A thread that ends moves all its free blocks to the depot.
+// Chunks are never returned to the system, but their blocks are reused by
+// every thread, so the memory held stays near the peak number of live
+// blocks instead of growing with the blocks that cross threads.
+template <size_t Size, size_t Align>
+class FixedPool {
+	union Slot {
+		Slot* next;
+		alignas(Align) unsigned char storage[Size];
+	};
+
+	static constexpr size_t MIN_CHUNK = 64;
+	static constexpr size_t MAX_CHUNK = 4096;
+	static constexpr size_t BATCH = 1024;
+	static constexpr size_t MAX_FREE = 2 * BATCH;
+
+	// Shared by all threads: every chunk, reachable for the whole program
+	// lifetime, and a free list of blocks handed back by the threads
+	struct Depot {
+		std::mutex guard;
+		std::vector<void*> chunks;
+		size_t chunkBytes = 0;
+		Slot* free_list = nullptr;
+		size_t free_count = 0;
+	};
+
+	Slot* free_list = nullptr;
+	size_t free_count = 0;
+	Slot* bump = nullptr;
+	Slot* bump_end = nullptr;
+	size_t next_chunk = MIN_CHUNK;
+
+	// Owns the pool of a thread and hands its blocks to the depot when
+	// the thread ends
+	struct Owner {
+		FixedPool pool;
+
+		Owner() { current() = &pool; }
+		~Owner() {
+			current() = nullptr;
+			finished() = true;
+			pool.release();
+		}
+	};
+
+	FixedPool() = default;
+
+	static Depot& depot() {
+		static Depot* shared = new Depot;
+		return *shared;
+	}
+
+	// trivially destructible, so still readable while thread_local objects
+	// are destroyed at thread exit
+	static FixedPool*& current() {
+		static thread_local FixedPool* pool = nullptr;
+		return pool;
+	}
+
+	static bool& finished() {
+		static thread_local bool done = false;
+		return done;
+	}
+
+	// Pool of this thread, nullptr once it is gone (blocks freed by
+	// destructors that run after it)
+	static FixedPool* local() {
+		FixedPool* pool = current();
+		if (!pool && !finished()) {
+			static thread_local Owner owner;
+			pool = &owner.pool;
+		}
+		return pool;
+	}
+
+	static Slot* newChunk(size_t slots) {
+		void* chunk = ::operator new(slots * sizeof(Slot), std::align_val_t(alignof(Slot)));
+		Depot& d = depot();
+		try {
+			std::lock_guard<std::mutex> lock(d.guard);
+			d.chunks.push_back(chunk);
+			d.chunkBytes += slots * sizeof(Slot);
+		}
+		catch (...) {
+			::operator delete(chunk, std::align_val_t(alignof(Slot)));
+			throw;
+		}
+		return static_cast<Slot*>(chunk);
+	}
+
+	// Moves the chain first .. last of count blocks to the depot
+	static void giveBack(Slot* first, Slot* last, size_t count) noexcept {
+		Depot& d = depot();
+		std::lock_guard<std::mutex> lock(d.guard);
+		last->next = d.free_list;
+		d.free_list = first;
+		d.free_count += count;
+	}
+
+	// Takes up to BATCH blocks from the depot into the free list
+	void refill() {
+		Depot& d = depot();
+		std::lock_guard<std::mutex> lock(d.guard);
+		if (!d.free_list)
+			return;
+		Slot* first = d.free_list;
+		Slot* last = first;
+		size_t n = 1;
+		for (; n < BATCH && last->next; ++n)
+			last = last->next;
+		d.free_list = last->next;
+		d.free_count -= n;
+		last->next = free_list;
+		free_list = first;
+		free_count += n;
+	}
+
+	void grow() {
+		bump = newChunk(next_chunk);
+		bump_end = bump + next_chunk;
+		if (next_chunk < MAX_CHUNK)
+			next_chunk *= 2;
+	}
+
+	void* take() {
+		if (!free_list)
+			refill();
+		if (free_list) {
+			Slot* slot = free_list;
+			free_list = slot->next;
+			--free_count;
+			return slot;
+		}
+		if (bump == bump_end)
+			grow();
+		return bump++;
+	}
+
+	void give(void* p) noexcept {
+		Slot* slot = static_cast<Slot*>(p);
+		slot->next = free_list;
+		free_list = slot;
+		if (++free_count > MAX_FREE) {
+			Slot* last = free_list;
+			for (size_t n = 1; n < BATCH; ++n)
+				last = last->next;
+			Slot* first = free_list;
+			free_list = last->next;
+			free_count -= BATCH;
+			giveBack(first, last, BATCH);
+		}
+	}
+
+	// Hands the free list and the uncarved rest of the chunk to the depot
+	void release() noexcept {
+		for (; bump != bump_end; ++bump) {
+			bump->next = free_list;
+			free_list = bump;
+			++free_count;
+		}
+		if (free_list) {
+			Slot* last = free_list;
+			while (last->next)
+				last = last->next;
+			giveBack(free_list, last, free_count);
+		}
+		free_list = nullptr;
+		free_count = 0;
+	}
+
+public:
+	FixedPool(const FixedPool&) = delete;
+	FixedPool& operator=(const FixedPool&) = delete;
+
+	static void* allocate() {
+		if (FixedPool* pool = local())
+			return pool->take();
+		// the thread's pool is gone, so take a block straight from the depot
+		Depot& d = depot();
+		{
+			std::lock_guard<std::mutex> lock(d.guard);
+			if (Slot* slot = d.free_list) {
+				d.free_list = slot->next;
+				--d.free_count;
+				return slot;
+			}
+		}
+		return newChunk(1);
+	}
+
+	static void deallocate(void* p) noexcept {
+		if (FixedPool* pool = local())
+			pool->give(p);
+		else {
+			Slot* slot = static_cast<Slot*>(p);
+			giveBack(slot, slot, 1);
+		}
+	}
+
+	// Bytes of all chunks taken from the system so far
+	static size_t reservedBytes() {
+		Depot& d = depot();
+		std::lock_guard<std::mutex> lock(d.guard);
+		return d.chunkBytes;
+	}
+
+	// Free blocks waiting in the depot
+	static size_t depotBlocks() {
+		Depot& d = depot();
+		std::lock_guard<std::mutex> lock(d.guard);
+		return d.free_count;
+	}
+};
+
+// Standard allocator on top of FixedPool. Single-object requests (the only
+// kind node-based containers make) come from the pool, arrays go to the heap.
+// All instances are interchangeable, so containers using it can exchange
+// nodes freely (splice, swap, move).
+template <class T>
+class PoolAllocator {
+	using Pool = FixedPool<sizeof(T), alignof(T)>;
+
+public:
+	using value_type = T;
+
+	PoolAllocator() noexcept = default;
+	template <class U>
+	PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+	T* allocate(size_t n) {
+		if (n == 1)
+			return static_cast<T*>(Pool::allocate());
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+	}
+
+	void deallocate(T* p, size_t n) noexcept {
+		if (n == 1)
+			Pool::deallocate(p);
+		else
+			::operator delete(p, std::align_val_t(alignof(T)));
+	}
+};
+
+template <class T, class U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept { return true; }
+
+template <class T, class U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept { return false; }
+
+#endif
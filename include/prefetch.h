@@ -0,0 +1,19 @@
+#ifndef __PREFETCH_H__
+#define __PREFETCH_H__
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
+
+// Hint that *p will be read soon. Never faults, so p may point anywhere.
+inline void prefetchRead(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER)
+	_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+	(void)p;
+#endif
+}
+
+#endif
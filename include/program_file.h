@@ -0,0 +1,289 @@
+#ifndef __PROGRAM_FILE_H__
+#define __PROGRAM_FILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "expression_program.h"
+#include "hash_table.h"
+#include "mapped_file.h"
+#include "table_file.h"
+
+// Bundle of compiled ExpressionPrograms in one binary file, mapped
+// read-only and run in place, so that worker processes share one
+// precompiled set of formulas instead of each parsing them at startup.
+// Opening checks the 64-byte header whatever the number of programs;
+// program(i) checks that one program stays within its constants, slots,
+// names and stack, in O(its code length), so a damaged file throws instead
+// of running out of bounds even when verify() isn't called.
+// Variable names are stored once per bundle and programs refer to them by
+// index. Like table files, a bundle is readable only on a machine of the
+// same byte order, and its checksum is read by verify() on request.
+//
+// Layout: the header, then these arrays, each 64-byte aligned:
+//  - programCount ProgramFileRecord
+//  - codeCount ProgramInstruction, the code of every program in turn
+//  - constantCount double, the constant pools in turn
+//  - slotCount uint32_t, the name index of every variable slot in turn
+//  - nameCount + 1 uint64_t offsets into the name bytes, then the bytes
+
+struct ProgramFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder; // BYTE_ORDER_MARK as the writer stored it
+	uint32_t programCount;
+	uint32_t codeCount;
+	uint32_t constantCount;
+	uint32_t slotCount;
+	uint32_t nameCount;
+	uint32_t reserved;
+	uint64_t nameBytes;
+	uint64_t payloadBytes; // bytes after the header
+	uint64_t checksum;     // of the payload
+
+	static constexpr char MAGIC[8] = { 'E', 'X', 'P', 'R', 'B', 'D', 'L', '\0' };
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+};
+
+static_assert(sizeof(ProgramFileHeader) == 64, "ProgramFileHeader must stay 64 bytes");
+
+struct ProgramFileRecord {
+	uint32_t codeBegin;
+	uint32_t codeLength;
+	uint32_t constantBegin;
+	uint32_t constantCount;
+	uint32_t slotBegin;
+	uint32_t slotCount;
+	uint32_t maxStack;
+	uint32_t reserved;
+};
+
+namespace program_file {
+
+// Payload offsets of the arrays, and the payload size, of a header
+struct Layout {
+	size_t code, constants, slots, nameOffsets, names, bytes;
+
+	explicit Layout(const ProgramFileHeader& h) {
+		using table_file::alignUp;
+		code = alignUp(size_t(h.programCount) * sizeof(ProgramFileRecord));
+		constants = code + alignUp(size_t(h.codeCount) * sizeof(ProgramInstruction));
+		slots = constants + alignUp(size_t(h.constantCount) * sizeof(double));
+		nameOffsets = slots + alignUp(size_t(h.slotCount) * sizeof(uint32_t));
+		names = nameOffsets + alignUp((size_t(h.nameCount) + 1) * sizeof(uint64_t));
+		bytes = names + size_t(h.nameBytes);
+	}
+};
+
+template <class T>
+void append(std::vector<uint8_t>& payload, size_t offset, const T* items, size_t count) {
+	if (count)
+		std::memcpy(payload.data() + offset, items, count * sizeof(T));
+}
+
+} // namespace program_file
+
+// Writes programs in order, so that program(i) of the bundle is programs[i]
+inline void saveProgramBundle(const std::string& path, const std::vector<ExpressionProgram>& programs) {
+	for (const ExpressionProgram& p : programs)
+		if (!p.isComplete())
+			throw std::invalid_argument("Invalid expression: the program doesn't leave exactly one value");
+	ProgramFileHeader header = {};
+	std::vector<ProgramFileRecord> records;
+	std::vector<uint32_t> slots;
+	std::vector<uint64_t> nameOffsets(1, 0);
+	std::string names;
+	HashTable<std::string_view, uint32_t> nameIndex;
+	records.reserve(programs.size());
+	for (const ExpressionProgram& p : programs) {
+		ProgramFileRecord r = {};
+		r.codeBegin = header.codeCount;
+		r.codeLength = uint32_t(p.code().size());
+		r.constantBegin = header.constantCount;
+		r.constantCount = uint32_t(p.constants().size());
+		r.slotBegin = uint32_t(slots.size());
+		r.slotCount = uint32_t(p.variableCount());
+		r.maxStack = uint32_t(p.maxStack());
+		records.push_back(r);
+		header.codeCount += r.codeLength;
+		header.constantCount += r.constantCount;
+		for (size_t slot = 0; slot < p.variableCount(); ++slot) {
+			std::string_view name = p.variable(slot);
+			uint32_t next = uint32_t(nameOffsets.size() - 1);
+			if (nameIndex.insert(name, next)) {
+				names += name;
+				nameOffsets.push_back(names.size());
+			}
+			slots.push_back(*nameIndex.find(name));
+		}
+	}
+	header.programCount = uint32_t(programs.size());
+	header.slotCount = uint32_t(slots.size());
+	header.nameCount = uint32_t(nameOffsets.size() - 1);
+	header.nameBytes = names.size();
+
+	program_file::Layout layout(header);
+	std::vector<uint8_t> payload(layout.bytes);
+	program_file::append(payload, 0, records.data(), records.size());
+	size_t code = layout.code, constants = layout.constants;
+	for (const ExpressionProgram& p : programs) {
+		program_file::append(payload, code, p.code().data(), p.code().size());
+		program_file::append(payload, constants, p.constants().data(), p.constants().size());
+		code += p.code().size() * sizeof(ProgramInstruction);
+		constants += p.constants().size() * sizeof(double);
+	}
+	program_file::append(payload, layout.slots, slots.data(), slots.size());
+	program_file::append(payload, layout.nameOffsets, nameOffsets.data(), nameOffsets.size());
+	program_file::append(payload, layout.names, names.data(), names.size());
+
+	std::memcpy(header.magic, ProgramFileHeader::MAGIC, sizeof(header.magic));
+	header.version = ProgramFileHeader::VERSION;
+	header.byteOrder = ProgramFileHeader::BYTE_ORDER_MARK;
+	header.payloadBytes = payload.size();
+	header.checksum = checksum64(payload.data(), payload.size());
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(payload.data()), std::streamsize(payload.size()));
+	if (!out)
+		throw std::runtime_error("Can't write " + path);
+}
+
+// A program of a mapped bundle, valid while the bundle is open
+class ProgramView {
+	const ProgramInstruction* instructions;
+	const double* pool;
+	const uint32_t* slotNames;
+	const uint64_t* nameOffsets;
+	const char* nameBytes;
+	uint32_t length;
+	uint32_t slots;
+	uint32_t maxDepth;
+
+public:
+	ProgramView(const ProgramInstruction* code, uint32_t length, const double* constants, const uint32_t* slotNames,
+		uint32_t slots, uint32_t maxStack, const uint64_t* nameOffsets, const char* nameBytes)
+		: instructions(code), pool(constants), slotNames(slotNames), nameOffsets(nameOffsets), nameBytes(nameBytes),
+		length(length), slots(slots), maxDepth(maxStack) {}
+
+	size_t codeLength() const { return length; }
+	size_t variableCount() const { return slots; }
+	size_t maxStack() const { return maxDepth; }
+
+	std::string_view variable(size_t slot) const {
+		uint32_t name = slotNames[slot];
+		return std::string_view(nameBytes + nameOffsets[name], size_t(nameOffsets[name + 1] - nameOffsets[name]));
+	}
+
+	// Slot of a variable, or variableCount() if the program doesn't use it
+	size_t slotOf(std::string_view name) const {
+		size_t slot = 0;
+		while (slot < slots && variable(slot) != name)
+			++slot;
+		return slot;
+	}
+
+	double evaluate(const double* values) const {
+		return runProgram(instructions, length, pool, values, maxDepth);
+	}
+
+	double evaluate(const std::vector<double>& values) const {
+		if (values.size() < slots)
+			throw std::invalid_argument("Expected a value for each of the " + std::to_string(slots) + " variables");
+		return evaluate(values.data());
+	}
+};
+
+class MappedProgramBundle {
+	MappedFile file;
+	const ProgramFileHeader* header;
+	const ProgramFileRecord* records;
+	const ProgramInstruction* code;
+	const double* constants;
+	const uint32_t* slots;
+	const uint64_t* nameOffsets;
+	const char* names;
+
+	[[noreturn]] void damaged() const {
+		throw std::runtime_error("Program bundle is damaged");
+	}
+
+public:
+	explicit MappedProgramBundle(const std::string& path) : file(path) {
+		if (file.size() < sizeof(ProgramFileHeader))
+			throw std::runtime_error(path + " is not a program bundle");
+		header = reinterpret_cast<const ProgramFileHeader*>(file.data());
+		if (std::memcmp(header->magic, ProgramFileHeader::MAGIC, sizeof(header->magic)) != 0)
+			throw std::runtime_error(path + " is not a program bundle");
+		if (header->version != ProgramFileHeader::VERSION)
+			throw std::runtime_error(path + " has unsupported program bundle version " + std::to_string(header->version));
+		if (header->byteOrder != ProgramFileHeader::BYTE_ORDER_MARK)
+			throw std::runtime_error(path + " was written with another byte order");
+		program_file::Layout layout(*header);
+		if (header->payloadBytes != file.size() - sizeof(ProgramFileHeader) || layout.bytes != header->payloadBytes)
+			throw std::runtime_error(path + " is truncated or damaged");
+
+		const uint8_t* payload = file.data() + sizeof(ProgramFileHeader);
+		records = reinterpret_cast<const ProgramFileRecord*>(payload);
+		code = reinterpret_cast<const ProgramInstruction*>(payload + layout.code);
+		constants = reinterpret_cast<const double*>(payload + layout.constants);
+		slots = reinterpret_cast<const uint32_t*>(payload + layout.slots);
+		nameOffsets = reinterpret_cast<const uint64_t*>(payload + layout.nameOffsets);
+		names = reinterpret_cast<const char*>(payload + layout.names);
+		if (nameOffsets[header->nameCount] != header->nameBytes)
+			damaged();
+	}
+
+	size_t size() const { return header->programCount; }
+	bool empty() const { return header->programCount == 0; }
+
+	// Distinct variable names over all programs
+	size_t nameCount() const { return header->nameCount; }
+
+	// Reads the whole payload and compares its checksum; a bundle that
+	// passes holds the programs as written, operands in bounds
+	bool verify() const {
+		return checksum64(file.data() + sizeof(ProgramFileHeader), size_t(header->payloadBytes)) == header->checksum;
+	}
+
+	ProgramView program(size_t i) const {
+		if (i >= header->programCount)
+			throw std::out_of_range("Program index out of range");
+		const ProgramFileRecord& r = records[i];
+		if (uint64_t(r.codeBegin) + r.codeLength > header->codeCount
+			|| uint64_t(r.constantBegin) + r.constantCount > header->constantCount
+			|| uint64_t(r.slotBegin) + r.slotCount > header->slotCount
+			|| r.maxStack > r.codeLength)
+			damaged();
+		for (size_t s = 0; s < r.slotCount; ++s) {
+			uint32_t name = slots[r.slotBegin + s];
+			if (name >= header->nameCount || nameOffsets[name] > nameOffsets[name + 1]
+				|| nameOffsets[name + 1] > header->nameBytes)
+				damaged();
+		}
+		// replays the stack depth, as ExpressionProgram::emit checked it
+		size_t depth = 0;
+		for (size_t k = 0; k < r.codeLength; ++k) {
+			ProgramInstruction in = code[r.codeBegin + k];
+			if (in.op() > OP_POW || depth < programPops(in.op()))
+				damaged();
+			if ((in.op() == OP_CONST && in.arg() >= r.constantCount) || (in.op() == OP_VAR && in.arg() >= r.slotCount))
+				damaged();
+			depth = depth - programPops(in.op()) + 1;
+			if (depth > r.maxStack)
+				damaged();
+		}
+		if (depth != 1)
+			damaged();
+		return ProgramView(code + r.codeBegin, r.codeLength, constants + r.constantBegin, slots + r.slotBegin, r.slotCount,
+			r.maxStack, nameOffsets, names);
+	}
+};
+
+#endif
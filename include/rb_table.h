@@ -0,0 +1,441 @@
+#ifndef __RB_TABLE_H__
+#define __RB_TABLE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Ordered table on a red-black tree whose nodes live in one vector and link
+// to each other by 32-bit indices. The color is the top bit of the left
+// link, so the tree costs 12 bytes per node (two links and the subtree
+// size) instead of three pointers, a flag and a count, and copying the
+// table is a plain vector copy. There are no parent
+// links: insert and erase record the search path in a fixed array (the
+// height is at most 2 log2(n + 1) < 64) and fix the tree up along it.
+// Erased slots are chained into a free list and reused by later inserts;
+// their key and value are moved out on erase, releasing what they own.
+// Nodes count their subtree, for O(log n) select and rank.
+template <class K, class V>
+class RBTable {
+	struct Node {
+		K key;
+		V value;
+		uint32_t left;  // top bit set for red nodes
+		uint32_t right; // next free slot while on the free list
+		uint32_t size;  // nodes in the subtree rooted here
+
+		Node(const K& k, const V& v) : key(k), value(v), left(0), right(0), size(1) {}
+	};
+
+	static constexpr uint32_t NIL = 0x7FFFFFFF;
+	static constexpr uint32_t RED = 0x80000000;
+	static constexpr int MAX_DEPTH = 72;
+
+	std::vector<Node> nodes;
+	uint32_t root;
+	uint32_t freeHead;
+	size_t count;
+
+	uint32_t left(uint32_t i) const { return nodes[i].left & NIL; }
+	uint32_t right(uint32_t i) const { return nodes[i].right; }
+	void setLeft(uint32_t i, uint32_t c) { nodes[i].left = (nodes[i].left & RED) | c; }
+	void setRight(uint32_t i, uint32_t c) { nodes[i].right = c; }
+	uint32_t sizeOf(uint32_t i) const { return i != NIL ? nodes[i].size : 0; }
+	void resize(uint32_t i) { nodes[i].size = 1 + sizeOf(left(i)) + sizeOf(right(i)); }
+
+	bool isRed(uint32_t i) const { return i != NIL && (nodes[i].left & RED) != 0; }
+	void setRed(uint32_t i) { nodes[i].left |= RED; }
+	void setBlack(uint32_t i) {
+		if (i != NIL)
+			nodes[i].left &= NIL;
+	}
+	void copyColor(uint32_t to, uint32_t from) {
+		nodes[to].left = (nodes[to].left & NIL) | (nodes[from].left & RED);
+	}
+
+	uint32_t allocate(const K& key, const V& value) {
+		uint32_t i;
+		if (freeHead != NIL) {
+			i = freeHead;
+			freeHead = nodes[i].right;
+			nodes[i].key = key;
+			nodes[i].value = value;
+		}
+		else {
+			if (nodes.size() >= NIL)
+				throw std::length_error("RBTable is full");
+			i = uint32_t(nodes.size());
+			nodes.push_back(Node(key, value));
+		}
+		nodes[i].left = NIL | RED;
+		nodes[i].right = NIL;
+		nodes[i].size = 1;
+		return i;
+	}
+
+	void release(uint32_t i) {
+		// moved into temporaries that die here, releasing what they own
+		{
+			[[maybe_unused]] K deadKey(std::move(nodes[i].key));
+			[[maybe_unused]] V deadValue(std::move(nodes[i].value));
+		}
+		nodes[i].right = freeHead;
+		freeHead = i;
+	}
+
+	// Puts node in place of child old of parent (NIL parent: the root)
+	void relink(uint32_t parent, uint32_t old, uint32_t node) {
+		if (parent == NIL)
+			root = node;
+		else if (left(parent) == old)
+			setLeft(parent, node);
+		else
+			setRight(parent, node);
+	}
+
+	// x's right child takes its place under parent
+	void rotateLeft(uint32_t x, uint32_t parent) {
+		uint32_t y = right(x);
+		setRight(x, left(y));
+		setLeft(y, x);
+		relink(parent, x, y);
+		nodes[y].size = nodes[x].size;
+		resize(x);
+	}
+
+	// x's left child takes its place under parent
+	void rotateRight(uint32_t x, uint32_t parent) {
+		uint32_t y = left(x);
+		setLeft(x, right(y));
+		setRight(y, x);
+		relink(parent, x, y);
+		nodes[y].size = nodes[x].size;
+		resize(x);
+	}
+
+	uint32_t findIndex(const K& key) const {
+		uint32_t n = root;
+		while (n != NIL) {
+			if (key < nodes[n].key)
+				n = left(n);
+			else if (nodes[n].key < key)
+				n = right(n);
+			else
+				return n;
+		}
+		return NIL;
+	}
+
+	// z is red with ancestors path[0 .. d)
+	void insertFixup(uint32_t z, uint32_t* path, int d) {
+		while (d >= 2 && isRed(path[d - 1])) {
+			uint32_t p = path[d - 1], g = path[d - 2];
+			uint32_t gp = d >= 3 ? path[d - 3] : NIL;
+			if (p == left(g)) {
+				uint32_t u = right(g);
+				if (isRed(u)) {
+					setBlack(p);
+					setBlack(u);
+					setRed(g);
+					z = g;
+					d -= 2;
+					continue;
+				}
+				if (z == right(p)) {
+					rotateLeft(p, g);
+					std::swap(z, p);
+				}
+				setBlack(p);
+				setRed(g);
+				rotateRight(g, gp);
+			}
+			else {
+				uint32_t u = left(g);
+				if (isRed(u)) {
+					setBlack(p);
+					setBlack(u);
+					setRed(g);
+					z = g;
+					d -= 2;
+					continue;
+				}
+				if (z == left(p)) {
+					rotateRight(p, g);
+					std::swap(z, p);
+				}
+				setBlack(p);
+				setRed(g);
+				rotateLeft(g, gp);
+			}
+			break;
+		}
+		setBlack(root);
+	}
+
+	// x (possibly NIL) carries an extra black; its parent is path[d - 1]
+	void eraseFixup(uint32_t x, uint32_t* path, int d) {
+		while (d > 0 && !isRed(x)) {
+			uint32_t p = path[d - 1];
+			uint32_t gp = d >= 2 ? path[d - 2] : NIL;
+			if (x == left(p)) {
+				uint32_t w = right(p);
+				if (isRed(w)) {
+					// make the sibling black: w moves above p
+					setBlack(w);
+					setRed(p);
+					rotateLeft(p, gp);
+					path[d - 1] = w;
+					path[d] = p;
+					++d;
+					gp = w;
+					w = right(p);
+				}
+				if (!isRed(left(w)) && !isRed(right(w))) {
+					setRed(w);
+					x = p;
+					--d;
+					continue;
+				}
+				if (!isRed(right(w))) {
+					setBlack(left(w));
+					setRed(w);
+					rotateRight(w, p);
+					w = right(p);
+				}
+				copyColor(w, p);
+				setBlack(p);
+				setBlack(right(w));
+				rotateLeft(p, gp);
+			}
+			else {
+				uint32_t w = left(p);
+				if (isRed(w)) {
+					setBlack(w);
+					setRed(p);
+					rotateRight(p, gp);
+					path[d - 1] = w;
+					path[d] = p;
+					++d;
+					gp = w;
+					w = left(p);
+				}
+				if (!isRed(left(w)) && !isRed(right(w))) {
+					setRed(w);
+					x = p;
+					--d;
+					continue;
+				}
+				if (!isRed(left(w))) {
+					setBlack(right(w));
+					setRed(w);
+					rotateLeft(w, p);
+					w = left(p);
+				}
+				copyColor(w, p);
+				setBlack(p);
+				setBlack(left(w));
+				rotateRight(p, gp);
+			}
+			x = root;
+			break;
+		}
+		setBlack(x);
+	}
+
+	// In-order walk from the first key not less than *lo (all keys if lo is
+	// null), f returns false to stop
+	template <class F>
+	void walk(const K* lo, F f) const {
+		uint32_t stack[MAX_DEPTH];
+		int top = 0;
+		for (uint32_t n = root; n != NIL;) {
+			if (lo && nodes[n].key < *lo)
+				n = right(n);
+			else {
+				stack[top++] = n;
+				n = left(n);
+			}
+		}
+		while (top > 0) {
+			uint32_t n = stack[--top];
+			if (!f(n))
+				return;
+			for (uint32_t c = right(n); c != NIL; c = left(c))
+				stack[top++] = c;
+		}
+	}
+
+	int blackHeight(uint32_t n, bool& ok) const {
+		if (n == NIL)
+			return 1;
+		if (isRed(n) && (isRed(left(n)) || isRed(right(n))))
+			ok = false;
+		if (nodes[n].size != 1 + sizeOf(left(n)) + sizeOf(right(n)))
+			ok = false;
+		int l = blackHeight(left(n), ok), r = blackHeight(right(n), ok);
+		if (l != r)
+			ok = false;
+		return l + (isRed(n) ? 0 : 1);
+	}
+
+public:
+	RBTable() : root(NIL), freeHead(NIL), count(0) {}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	void clear() {
+		nodes.clear();
+		root = NIL;
+		freeHead = NIL;
+		count = 0;
+	}
+
+	void reserve(size_t n) { nodes.reserve(n); }
+
+	// Bytes held by the node array, free slots and spare capacity included
+	size_t memoryUsage() const { return nodes.capacity() * sizeof(Node); }
+
+	// Checks the red-black properties and the subtree sizes (for tests)
+	bool isValid() const {
+		bool ok = !isRed(root);
+		blackHeight(root, ok);
+		return ok;
+	}
+
+	V* find(const K& key) {
+		uint32_t n = findIndex(key);
+		return n != NIL ? &nodes[n].value : nullptr;
+	}
+
+	const V* find(const K& key) const {
+		uint32_t n = findIndex(key);
+		return n != NIL ? &nodes[n].value : nullptr;
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		uint32_t path[MAX_DEPTH];
+		int d = 0;
+		for (uint32_t n = root; n != NIL;) {
+			path[d++] = n;
+			if (key < nodes[n].key)
+				n = left(n);
+			else if (nodes[n].key < key)
+				n = right(n);
+			else
+				return false;
+		}
+
+		uint32_t z = allocate(key, value);
+		for (int i = 0; i < d; ++i)
+			++nodes[path[i]].size;
+		if (d == 0)
+			root = z;
+		else if (key < nodes[path[d - 1]].key)
+			setLeft(path[d - 1], z);
+		else
+			setRight(path[d - 1], z);
+		++count;
+		insertFixup(z, path, d);
+		return true;
+	}
+
+	bool erase(const K& key) {
+		uint32_t path[MAX_DEPTH];
+		int d = 0;
+		uint32_t z = root;
+		while (z != NIL && (key < nodes[z].key || nodes[z].key < key)) {
+			path[d++] = z;
+			z = key < nodes[z].key ? left(z) : right(z);
+		}
+		if (z == NIL)
+			return false;
+
+		// a node with two children takes over its successor's entry,
+		// and the successor (which has no left child) is unlinked instead
+		uint32_t y = z;
+		if (left(z) != NIL && right(z) != NIL) {
+			path[d++] = z;
+			for (y = right(z); left(y) != NIL; y = left(y))
+				path[d++] = y;
+			nodes[z].key = std::move(nodes[y].key);
+			nodes[z].value = std::move(nodes[y].value);
+		}
+
+		uint32_t x = left(y) != NIL ? left(y) : right(y);
+		relink(d > 0 ? path[d - 1] : NIL, y, x);
+		for (int i = 0; i < d; ++i)
+			--nodes[path[i]].size;
+		bool black = !isRed(y);
+		release(y);
+		--count;
+		if (black)
+			eraseFixup(x, path, d);
+		return true;
+	}
+
+	// Key of the entry with k smaller keys (k counts from 0), null if
+	// k >= size(); find gives its value
+	const K* select(size_t k) const {
+		uint32_t n = root;
+		while (n != NIL) {
+			size_t l = sizeOf(left(n));
+			if (k < l)
+				n = left(n);
+			else if (k == l)
+				return &nodes[n].key;
+			else {
+				k -= l + 1;
+				n = right(n);
+			}
+		}
+		return nullptr;
+	}
+
+	// Number of entries whose key is less than key
+	size_t rank(const K& key) const {
+		size_t r = 0;
+		for (uint32_t n = root; n != NIL;) {
+			if (nodes[n].key < key) {
+				r += sizeOf(left(n)) + 1;
+				n = right(n);
+			}
+			else
+				n = left(n);
+		}
+		return r;
+	}
+
+	// f(key, value) for every entry with lo <= key < hi, in key order
+	template <class F>
+	void range(const K& lo, const K& hi, F f) const {
+		walk(&lo, [&](uint32_t n) {
+			if (!(nodes[n].key < hi))
+				return false;
+			f(nodes[n].key, nodes[n].value);
+			return true;
+		});
+	}
+
+	// f(key, value) for every entry in key order
+	template <class F>
+	void for_each(F f) const {
+		walk(nullptr, [&](uint32_t n) {
+			f(nodes[n].key, nodes[n].value);
+			return true;
+		});
+	}
+
+	template <class F>
+	void for_each(F f) {
+		walk(nullptr, [&](uint32_t n) {
+			f(static_cast<const K&>(nodes[n].key), nodes[n].value);
+			return true;
+		});
+	}
+};
+
+#endif
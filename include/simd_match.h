@@ -0,0 +1,51 @@
+#ifndef __SIMD_MATCH_H__
+#define __SIMD_MATCH_H__
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_MATCH_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define SIMD_MATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Byte-group compares for metadata arrays: bit i of the result is set when
+// p[i] == b. Plain loops are the fallback on targets without SSE2.
+
+inline uint32_t matchByte16(const uint8_t* p, uint8_t b) {
+#if defined(SIMD_MATCH_SSE2)
+	__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(char(b)))));
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < 16; ++i)
+		mask |= uint32_t(p[i] == b) << i;
+	return mask;
+#endif
+}
+
+// Bit i set when the top bit of p[i] is set
+inline uint32_t matchHighBit16(const uint8_t* p) {
+#if defined(SIMD_MATCH_SSE2)
+	return uint32_t(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < 16; ++i)
+		mask |= uint32_t(p[i] >> 7) << i;
+	return mask;
+#endif
+}
+
+inline uint32_t matchByte32(const uint8_t* p, uint8_t b) {
+#if defined(SIMD_MATCH_AVX2)
+	__m256i group = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(group, _mm256_set1_epi8(char(b)))));
+#else
+	return matchByte16(p, b) | (matchByte16(p + 16, b) << 16);
+#endif
+}
+
+#endif
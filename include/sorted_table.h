@@ -0,0 +1,237 @@
+#ifndef __SORTED_TABLE_H__
+#define __SORTED_TABLE_H__
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "prefetch.h"
+
+// Calls f(k) for every node k of an Eytzinger array of count nodes in key
+// order, without recursion
+template <class F>
+void eytzingerInOrder(size_t count, F f) {
+	if (count == 0)
+		return;
+	size_t k = 1;
+	while (2 * k <= count)
+		k = 2 * k;
+	while (k != 0) {
+		f(k);
+		if (2 * k + 1 <= count) {
+			k = 2 * k + 1;
+			while (2 * k <= count)
+				k = 2 * k;
+		}
+		else {
+			// climb while coming back from a right child
+			while (k & 1)
+				k >>= 1;
+			k >>= 1;
+		}
+	}
+}
+
+// Index of the first key not less than key in the Eytzinger array
+// keys[1 .. count] (keys[0] unused), 0 if there is none. Shared by
+// SortedTable and its read-only mapped form in table_file.h.
+template <class K>
+size_t eytzingerLowerBound(const K* keys, size_t count, const K& key) {
+	constexpr size_t PREFETCH_STRIDE = 16;
+	size_t k = 1;
+	while (k <= count) {
+		prefetchRead(keys + PREFETCH_STRIDE * k);
+		k = 2 * k + size_t(keys[k] < key);
+	}
+	// the last left turn was at the answer, every turn after it went right
+	return k >> (std::countr_one(k) + 1);
+}
+
+// Read-mostly ordered table. Keys are stored in Eytzinger (BFS) order: node
+// k has children 2k and 2k + 1, so every search touches the same few cache
+// lines for the top levels. The descent k = 2k + (keys[k] < key) has no
+// data-dependent branch, and the node four levels below is prefetched: its
+// 16 descendants are contiguous. Values live in a parallel array.
+// Bulk build is O(n log n); insert and erase relayout the arrays in O(n).
+template <class K, class V>
+class SortedTable {
+	// keys[0] is padding (a copy of some key) so that the root is index 1;
+	// vals[k - 1] belongs to keys[k]
+	std::vector<K> keys;
+	std::vector<V> vals;
+
+	static constexpr size_t PREFETCH_STRIDE = 16;
+	static constexpr size_t GROUP = 16;
+
+	size_t n() const { return vals.size(); }
+
+	// Lays out strictly increasing keys and their values
+	void layout(std::vector<K>& sk, std::vector<V>& sv) {
+		keys.clear();
+		vals.clear();
+		if (sk.empty())
+			return;
+
+		std::vector<size_t> rank(sk.size() + 1);
+		size_t i = 0;
+		eytzingerInOrder(sk.size(), [&](size_t k) { rank[k] = i++; });
+
+		keys.reserve(sk.size() + 1);
+		vals.reserve(sk.size());
+		keys.push_back(sk[0]);
+		for (size_t k = 1; k <= sk.size(); ++k) {
+			keys.push_back(std::move(sk[rank[k]]));
+			vals.push_back(std::move(sv[rank[k]]));
+		}
+	}
+
+	void toSorted(std::vector<K>& sk, std::vector<V>& sv) {
+		sk.reserve(n());
+		sv.reserve(n());
+		eytzingerInOrder(n(), [&](size_t k) {
+			sk.push_back(std::move(keys[k]));
+			sv.push_back(std::move(vals[k - 1]));
+		});
+	}
+
+	size_t indexOf(const K& key) const {
+		size_t k = eytzingerLowerBound(keys.data(), n(), key);
+		return (k != 0 && !(key < keys[k])) ? k : 0;
+	}
+
+	// Searches a group of queries level by level, so that their cache misses
+	// overlap instead of being paid one after another
+	void indicesOf(const K* queries, size_t m, size_t* idx) const {
+		const K* base = keys.data();
+		size_t count = n();
+		// levels that are complete, every search is still inside the tree
+		size_t full = std::bit_width(count + 1) - 1;
+
+		for (size_t j = 0; j < m; ++j)
+			idx[j] = 1;
+		for (size_t level = 0; level < full; ++level)
+			for (size_t j = 0; j < m; ++j) {
+				prefetchRead(base + PREFETCH_STRIDE * idx[j]);
+				idx[j] = 2 * idx[j] + size_t(base[idx[j]] < queries[j]);
+			}
+
+		for (size_t j = 0; j < m; ++j) {
+			size_t k = idx[j];
+			if (k <= count)
+				k = 2 * k + size_t(base[k] < queries[j]);
+			k >>= std::countr_one(k) + 1;
+			idx[j] = (k != 0 && !(queries[j] < base[k])) ? k : 0;
+		}
+	}
+
+	template <class P>
+	void findBatchImpl(std::span<const K> queries, std::span<P> out) const {
+		if (queries.size() != out.size())
+			throw std::invalid_argument("Query and result spans must have the same size");
+		size_t idx[GROUP];
+		for (size_t start = 0; start < queries.size(); start += GROUP) {
+			size_t m = std::min(GROUP, queries.size() - start);
+			if (vals.empty())
+				std::fill(idx, idx + m, size_t(0));
+			else
+				indicesOf(queries.data() + start, m, idx);
+			for (size_t j = 0; j < m; ++j)
+				out[start + j] = idx[j] ? const_cast<P>(&vals[idx[j] - 1]) : nullptr;
+		}
+	}
+
+public:
+	SortedTable() {}
+
+	// Bulk build from unsorted pairs; of equal keys the last one wins
+	explicit SortedTable(std::vector<std::pair<K, V>> items) {
+		std::stable_sort(items.begin(), items.end(),
+			[](const std::pair<K, V>& a, const std::pair<K, V>& b) { return a.first < b.first; });
+
+		std::vector<K> sk;
+		std::vector<V> sv;
+		sk.reserve(items.size());
+		sv.reserve(items.size());
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (i + 1 < items.size() && !(items[i].first < items[i + 1].first))
+				continue;
+			sk.push_back(std::move(items[i].first));
+			sv.push_back(std::move(items[i].second));
+		}
+		layout(sk, sv);
+	}
+
+	size_t size() const { return vals.size(); }
+	bool empty() const { return vals.empty(); }
+
+	// The arrays in Eytzinger order, for writing them out: size() + 1 keys
+	// with an unused keys[0] (none at all when empty), and size() values
+	const K* layoutKeys() const { return keys.data(); }
+	const V* layoutValues() const { return vals.data(); }
+
+	void clear() {
+		keys.clear();
+		vals.clear();
+	}
+
+	V* find(const K& key) {
+		size_t k = empty() ? 0 : indexOf(key);
+		return k ? &vals[k - 1] : nullptr;
+	}
+
+	const V* find(const K& key) const {
+		return const_cast<SortedTable*>(this)->find(key);
+	}
+
+	// out[i] = find(queries[i]) for a whole batch of keys
+	void findBatch(std::span<const K> queries, std::span<V*> out) {
+		findBatchImpl(queries, out);
+	}
+
+	void findBatch(std::span<const K> queries, std::span<const V*> out) const {
+		findBatchImpl(queries, out);
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		if (find(key))
+			return false;
+		std::vector<K> sk;
+		std::vector<V> sv;
+		toSorted(sk, sv);
+		size_t pos = size_t(std::lower_bound(sk.begin(), sk.end(), key) - sk.begin());
+		sk.insert(sk.begin() + pos, key);
+		sv.insert(sv.begin() + pos, value);
+		layout(sk, sv);
+		return true;
+	}
+
+	bool erase(const K& key) {
+		if (!find(key))
+			return false;
+		std::vector<K> sk;
+		std::vector<V> sv;
+		toSorted(sk, sv);
+		size_t pos = size_t(std::lower_bound(sk.begin(), sk.end(), key) - sk.begin());
+		sk.erase(sk.begin() + pos);
+		sv.erase(sv.begin() + pos);
+		layout(sk, sv);
+		return true;
+	}
+
+	// f(key, value) for every entry in ascending key order
+	template <class F>
+	void for_each(F f) const {
+		eytzingerInOrder(n(), [&](size_t k) { f(keys[k], vals[k - 1]); });
+	}
+
+	template <class F>
+	void for_each(F f) {
+		eytzingerInOrder(n(), [&](size_t k) { f(static_cast<const K&>(keys[k]), vals[k - 1]); });
+	}
+};
+
+#endif
@@ -64,7 +64,7 @@ public:
 	T pop() {
 		if (empty())
 			throw std::runtime_error("Can't delete element from empty stack");
-		T elem = data.back();
+		T elem = std::move(data.back());
 		data.pop_back();
 		size--;
 		return elem;
@@ -0,0 +1,86 @@
+#ifndef __STRING_INTERNER_H__
+#define __STRING_INTERNER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "hash_table.h"
+
+// Stable 32-bit IDs for strings such as identifiers: the first intern of
+// a text gives it the next ID, later ones return the same ID, so symbol
+// tables can compare and hash IDs instead of text. Every distinct text is
+// copied once into an arena of chunks that never move, so the views
+// returned by name() stay valid for the life of the interner.
+// Not thread-safe.
+class StringInterner {
+	static constexpr size_t MIN_CHUNK = 4096;
+	static constexpr size_t MAX_CHUNK = 1 << 20;
+
+	std::vector<std::unique_ptr<char[]>> chunks;
+	char* bump;
+	size_t left;     // bytes after bump in the current chunk
+	size_t nextChunk;
+	size_t used;     // bytes of text stored
+	std::vector<std::string_view> names;
+	HashTable<std::string_view, uint32_t> ids;
+
+	const char* store(std::string_view text) {
+		if (text.size() > left) {
+			// a text longer than a chunk gets a chunk of its own
+			size_t size = text.size() > nextChunk ? text.size() : nextChunk;
+			chunks.emplace_back(new char[size]);
+			bump = chunks.back().get();
+			left = size;
+			if (nextChunk < MAX_CHUNK)
+				nextChunk *= 2;
+		}
+		char* p = bump;
+		if (!text.empty())
+			std::memcpy(p, text.data(), text.size());
+		bump += text.size();
+		left -= text.size();
+		used += text.size();
+		return p;
+	}
+
+public:
+	static constexpr uint32_t NONE = ~uint32_t(0);
+
+	StringInterner() : bump(nullptr), left(0), nextChunk(MIN_CHUNK), used(0) {}
+
+	// Views into the arena are handed out, so it never moves or copies
+	StringInterner(const StringInterner&) = delete;
+	StringInterner& operator=(const StringInterner&) = delete;
+
+	size_t size() const { return names.size(); }
+	bool empty() const { return names.empty(); }
+
+	// Bytes of text stored, each distinct text once
+	size_t textBytes() const { return used; }
+
+	uint32_t intern(std::string_view text) {
+		if (const uint32_t* id = ids.find(text))
+			return *id;
+		if (names.size() == NONE)
+			throw std::length_error("StringInterner is full");
+		std::string_view stored(store(text), text.size());
+		uint32_t id = uint32_t(names.size());
+		names.push_back(stored);
+		ids.insert(stored, id);
+		return id;
+	}
+
+	// ID of a text interned before, NONE if there is none
+	uint32_t find(std::string_view text) const {
+		const uint32_t* id = ids.find(text);
+		return id ? *id : NONE;
+	}
+
+	std::string_view name(uint32_t id) const { return names[id]; }
+};
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef __TABLE_H__
+#define __TABLE_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "avl_table.h"
+#include "hash_table.h"
+#include "rb_table.h"
+#include "sorted_table.h"
+#include "unsorted_table.h"
+
+// One table interface over the five backends. A fixed backend behaves
+// exactly like the table it wraps. The auto policies count reads and writes
+// and, once the number of operations since the last check reaches the
+// table size, pick the backend that suits the observed size and mix and
+// move the entries there. A migration costs O(n) and follows at least n
+// operations, so it adds O(1) amortized per operation, and a catalog that
+// grows from ten entries to millions changes backend on the way.
+//  - auto: unsorted scan while small, hash table after that. This choice
+//    is by size only: reads and writes both cost a scan on the unsorted
+//    table and O(1) on the hash table, so the mix doesn't move the
+//    crossover (bench_tables shows none between 16 and 128 entries)
+//  - auto ordered (for_each in key order): Eytzinger sorted array while
+//    reads outweigh the O(n) cost of its writes, else AVL for read-mostly
+//    and red-black for write-heavy mixes
+// K needs operator<, operator== and TableHash<K>, as every backend is
+// compiled in. In the auto policies any non-const call may move entries,
+// invalidating pointers returned by find.
+template <class K, class V>
+class Table {
+public:
+	// the concrete backends come first, in the order of the variant below
+	enum Backend { BACKEND_UNSORTED, BACKEND_SORTED, BACKEND_AVL, BACKEND_RB, BACKEND_HASH, BACKEND_AUTO, BACKEND_AUTO_ORDERED };
+
+	// auto keeps the unsorted scan up to this size
+	static constexpr size_t SMALL_SIZE = 32;
+	// auto ordered keeps the sorted array while writes * size <= reads * this
+	static constexpr size_t SORTED_READ_GAIN = 16;
+	// and prefers AVL to red-black while reads >= writes * this
+	static constexpr size_t AVL_READ_RATIO = 4;
+	static constexpr size_t MIN_CHECK_INTERVAL = 64;
+
+private:
+	typedef std::variant<UnsortedTable<K, V>, SortedTable<K, V>, AVLTable<K, V>, RBTable<K, V>, HashTable<K, V>> Impl;
+
+	Impl impl;
+	Backend policy;
+	// Count of reads that const find may bump from several threads at
+	// once; relaxed, as the policies only need its rough size
+	struct ReadCount {
+		std::atomic<size_t> n;
+
+		ReadCount(size_t v = 0) : n(v) {}
+		ReadCount(const ReadCount& other) : n(size_t(other)) {}
+		ReadCount& operator=(const ReadCount& other) { return *this = size_t(other); }
+		ReadCount& operator=(size_t v) {
+			n.store(v, std::memory_order_relaxed);
+			return *this;
+		}
+		void operator++() { n.fetch_add(1, std::memory_order_relaxed); }
+		operator size_t() const { return n.load(std::memory_order_relaxed); }
+	};
+
+	// operations since the last check of the auto policies
+	mutable ReadCount reads;
+	size_t writes;
+	size_t migrations;
+
+	static bool isAuto(Backend b) { return b == BACKEND_AUTO || b == BACKEND_AUTO_ORDERED; }
+	static bool isOrdered(Backend b) { return b == BACKEND_SORTED || b == BACKEND_AVL || b == BACKEND_RB; }
+
+	static Backend initial(Backend b) {
+		if (b == BACKEND_AUTO)
+			return BACKEND_UNSORTED;
+		if (b == BACKEND_AUTO_ORDERED)
+			return BACKEND_SORTED;
+		return b;
+	}
+
+	// A mix must beat a threshold by a factor of 2 to enter the sorted array
+	// or the AVL tree, but only fall short by that factor to leave it, so a
+	// mix close to a threshold doesn't move the entries back and forth
+	static Backend chooseBackend(Backend policy, Backend current, size_t n, size_t reads, size_t writes) {
+		if (policy == BACKEND_AUTO)
+			return n <= SMALL_SIZE ? BACKEND_UNSORTED : BACKEND_HASH;
+		size_t enter = current == BACKEND_SORTED ? 1 : 2;
+		if (enter * writes * n <= reads * SORTED_READ_GAIN)
+			return BACKEND_SORTED;
+		size_t leave = current == BACKEND_AVL ? 2 : 1;
+		return leave * reads >= writes * AVL_READ_RATIO ? BACKEND_AVL : BACKEND_RB;
+	}
+
+	// Re-evaluates the auto policy before a non-const operation
+	void adapt() {
+		if (!isAuto(policy) || reads + writes < std::max(MIN_CHECK_INTERVAL, size()))
+			return;
+		Backend b = chooseBackend(policy, backend(), size(), reads, writes);
+		reads = 0;
+		writes = 0;
+		if (b != backend())
+			migrate(b);
+	}
+
+	template <size_t I>
+	void refill(std::vector<std::pair<K, V>>& items) {
+		auto& t = impl.template emplace<I>();
+		if constexpr (requires { t.reserve(items.size()); })
+			t.reserve(items.size());
+		for (size_t i = 0; i < items.size(); ++i)
+			t.insert(items[i].first, items[i].second);
+	}
+
+	void migrate(Backend b) {
+		std::vector<std::pair<K, V>> items;
+		items.reserve(size());
+		std::visit([&](auto& t) {
+			t.for_each([&](const K& k, V& v) { items.emplace_back(k, std::move(v)); });
+			t.clear();
+		}, impl);
+
+		auto byKey = [](const std::pair<K, V>& a, const std::pair<K, V>& b) { return a.first < b.first; };
+		switch (b) {
+		case BACKEND_UNSORTED: refill<BACKEND_UNSORTED>(items); break;
+		case BACKEND_SORTED: impl.template emplace<BACKEND_SORTED>(std::move(items)); break;
+		case BACKEND_AVL:
+			// entries of the ordered backends already come in key order
+			if (!std::is_sorted(items.begin(), items.end(), byKey))
+				std::sort(items.begin(), items.end(), byKey);
+			impl.template emplace<BACKEND_AVL>(std::move(items));
+			break;
+		case BACKEND_RB: refill<BACKEND_RB>(items); break;
+		default: refill<BACKEND_HASH>(items); break;
+		}
+		++migrations;
+	}
+
+public:
+	explicit Table(Backend backend = BACKEND_AUTO) : policy(backend), reads(0), writes(0), migrations(0) {
+		Backend b = initial(backend);
+		if (b != BACKEND_UNSORTED)
+			migrate(b);
+		migrations = 0;
+	}
+
+	size_t size() const {
+		return std::visit([](const auto& t) { return t.size(); }, impl);
+	}
+
+	bool empty() const { return size() == 0; }
+
+	// The backend holding the entries now
+	Backend backend() const { return Backend(impl.index()); }
+
+	Backend backendPolicy() const { return policy; }
+
+	// Number of times the entries moved to another backend
+	size_t migrationCount() const { return migrations; }
+
+	// Changes the policy, moving the entries at once if the backend changes
+	void setBackend(Backend backend) {
+		policy = backend;
+		reads = 0;
+		writes = 0;
+		Backend b = backend;
+		if (backend == BACKEND_AUTO)
+			b = chooseBackend(backend, this->backend(), size(), 0, 0);
+		else if (backend == BACKEND_AUTO_ORDERED)
+			b = isOrdered(this->backend()) ? this->backend() : BACKEND_RB;
+		if (b != this->backend())
+			migrate(b);
+	}
+
+	// Also forgets the workload seen so far
+	void clear() {
+		std::visit([](auto& t) { t.clear(); }, impl);
+		reads = 0;
+		writes = 0;
+	}
+
+	V* find(const K& key) {
+		adapt();
+		++reads;
+		return std::visit([&](auto& t) { return t.find(key); }, impl);
+	}
+
+	// Counts toward the auto policies but never migrates; safe to call
+	// from several threads at once, like any const member
+	const V* find(const K& key) const {
+		++reads;
+		return std::visit([&](const auto& t) { return t.find(key); }, impl);
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		adapt();
+		++writes;
+		return std::visit([&](auto& t) { return t.insert(key, value); }, impl);
+	}
+
+	bool erase(const K& key) {
+		adapt();
+		++writes;
+		return std::visit([&](auto& t) { return t.erase(key); }, impl);
+	}
+
+	// f(key, value) for every entry, in key order on the ordered backends
+	template <class F>
+	void for_each(F f) const {
+		std::visit([&](const auto& t) { t.for_each(f); }, impl);
+	}
+
+	template <class F>
+	void for_each(F f) {
+		std::visit([&](auto& t) { t.for_each(f); }, impl);
+	}
+};
+
+#endif
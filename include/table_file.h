@@ -0,0 +1,278 @@
+#ifndef __TABLE_FILE_H__
+#define __TABLE_FILE_H__
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "hash_table.h"
+#include "mapped_file.h"
+#include "sorted_table.h"
+#include "table_hash.h"
+
+// Binary files of a SortedTable or a HashTable that are mapped read-only
+// and searched in place: opening one costs a few system calls and checks
+// of the 64-byte header, whatever the number of entries, and pages are read
+// in as lookups touch them. Keys and values must be trivially copyable;
+// the file is only readable on a machine of the same byte order, and a
+// hash table file with the same Hash, which must not depend on the process.
+//
+// Layout: the header, then the payload, every array 64-byte aligned.
+//  - sorted: keys in Eytzinger order (count + 1 with an unused keys[0],
+//    none when empty), then count values
+//  - hash: capacity control bytes, then capacity {key, value} slots in the
+//    probe layout of HashTable (SwissControl), free slots zeroed
+// The checksum covers the payload; reading it all defeats the point of
+// mapping, so it is checked by verify() on request, not on open.
+
+struct TableFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t kind;
+	uint32_t keySize;
+	uint32_t valueSize;
+	uint64_t count;        // entries
+	uint64_t capacity;     // slots of a hash table, entries of a sorted one
+	uint64_t payloadBytes; // bytes after the header
+	uint64_t checksum;     // of the payload
+	uint32_t byteOrder;    // BYTE_ORDER_MARK as the writer stored it
+	uint32_t reserved;
+
+	static constexpr char MAGIC[8] = { 'T', 'B', 'L', 'F', 'I', 'L', 'E', '\0' };
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t SORTED = 1;
+	static constexpr uint32_t HASH = 2;
+	static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+};
+
+static_assert(sizeof(TableFileHeader) == 64, "TableFileHeader must stay 64 bytes");
+
+// Slot of a hash table file
+template <class K, class V>
+struct TableFileSlot {
+	K key;
+	V value;
+};
+
+// 64-bit checksum of a byte range, 8 bytes per step
+inline uint64_t checksum64(const uint8_t* data, size_t bytes) {
+	uint64_t h = 0x9E3779B97F4A7C15ull ^ bytes;
+	size_t i = 0;
+	for (; i + 8 <= bytes; i += 8) {
+		uint64_t w;
+		std::memcpy(&w, data + i, 8);
+		h = std::rotl(h ^ (w * 0x87C37B91114253D5ull), 31) * 0x4CF5AD432745937Full;
+	}
+	uint64_t tail = 0;
+	if (bytes > i)
+		std::memcpy(&tail, data + i, bytes - i);
+	return hashMix(h ^ tail);
+}
+
+namespace table_file {
+
+inline size_t alignUp(size_t n) { return (n + 63) & ~size_t(63); }
+
+// Offset of the values in a sorted payload, and its size
+inline size_t sortedValuesOffset(size_t count, size_t keySize) { return alignUp(count ? (count + 1) * keySize : 0); }
+inline size_t sortedBytes(size_t count, size_t keySize, size_t valueSize) {
+	return sortedValuesOffset(count, keySize) + count * valueSize;
+}
+
+// Offset of the slots in a hash payload, and its size
+inline size_t hashSlotsOffset(size_t capacity) { return alignUp(capacity); }
+inline size_t hashBytes(size_t capacity, size_t slotSize) { return hashSlotsOffset(capacity) + capacity * slotSize; }
+
+inline void write(const std::string& path, TableFileHeader header, const std::vector<uint8_t>& payload) {
+	std::memcpy(header.magic, TableFileHeader::MAGIC, sizeof(header.magic));
+	header.version = TableFileHeader::VERSION;
+	header.payloadBytes = payload.size();
+	header.checksum = checksum64(payload.data(), payload.size());
+	header.byteOrder = TableFileHeader::BYTE_ORDER_MARK;
+	header.reserved = 0;
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(payload.data()), std::streamsize(payload.size()));
+	if (!out)
+		throw std::runtime_error("Can't write " + path);
+}
+
+// Maps path and checks that it is a complete table file of the given kind
+// and entry sizes; the caller checks the payload layout
+inline const TableFileHeader* open(MappedFile& file, const std::string& path, uint32_t kind, size_t keySize,
+	size_t valueSize) {
+	file.open(path);
+	if (file.size() < sizeof(TableFileHeader))
+		throw std::runtime_error(path + " is not a table file");
+	const TableFileHeader* h = reinterpret_cast<const TableFileHeader*>(file.data());
+	if (std::memcmp(h->magic, TableFileHeader::MAGIC, sizeof(h->magic)) != 0)
+		throw std::runtime_error(path + " is not a table file");
+	if (h->version != TableFileHeader::VERSION)
+		throw std::runtime_error(path + " has unsupported table file version " + std::to_string(h->version));
+	if (h->byteOrder != TableFileHeader::BYTE_ORDER_MARK)
+		throw std::runtime_error(path + " was written with another byte order");
+	if (h->kind != kind || h->keySize != keySize || h->valueSize != valueSize)
+		throw std::runtime_error(path + " holds another kind of table");
+	if (h->payloadBytes != file.size() - sizeof(TableFileHeader))
+		throw std::runtime_error(path + " is truncated");
+	return h;
+}
+
+inline void checkLayout(bool ok, const std::string& path) {
+	if (!ok)
+		throw std::runtime_error(path + " has a damaged header");
+}
+
+} // namespace table_file
+
+// Writes a sorted table in its Eytzinger layout
+template <class K, class V>
+void saveTable(const std::string& path, const SortedTable<K, V>& table) {
+	static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>, "Table files hold trivially copyable keys and values");
+	size_t n = table.size();
+	std::vector<uint8_t> payload(table_file::sortedBytes(n, sizeof(K), sizeof(V)));
+	if (n) {
+		std::memcpy(payload.data(), table.layoutKeys(), (n + 1) * sizeof(K));
+		std::memcpy(payload.data() + table_file::sortedValuesOffset(n, sizeof(K)), table.layoutValues(), n * sizeof(V));
+	}
+
+	TableFileHeader header = {};
+	header.kind = TableFileHeader::SORTED;
+	header.keySize = sizeof(K);
+	header.valueSize = sizeof(V);
+	header.count = n;
+	header.capacity = n;
+	table_file::write(path, header, payload);
+}
+
+// Writes a hash table, laid out afresh at the smallest capacity that holds
+// its entries (no tombstones, no resize in progress)
+template <class K, class V, class Hash, class Eq>
+void saveTable(const std::string& path, const HashTable<K, V, Hash, Eq>& table) {
+	static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>, "Table files hold trivially copyable keys and values");
+	typedef TableFileSlot<K, V> Slot;
+	size_t capacity = SwissControl::GROUP;
+	while (SwissControl::maxLoad(capacity) < table.size())
+		capacity *= 2;
+
+	std::vector<uint8_t> payload(table_file::hashBytes(capacity, sizeof(Slot)));
+	uint8_t* ctrl = payload.data();
+	uint8_t* slots = payload.data() + table_file::hashSlotsOffset(capacity);
+	std::memset(ctrl, SwissControl::EMPTY, capacity);
+	Hash hasher;
+	table.for_each([&](const K& key, const V& value) {
+		size_t h = hasher(key);
+		size_t i = SwissControl::freeSlot(ctrl, capacity, h);
+		ctrl[i] = SwissControl::tagOf(h);
+		// padding zeroed, so the same table always gives the same bytes
+		Slot s;
+		std::memset(&s, 0, sizeof(s));
+		s.key = key;
+		s.value = value;
+		std::memcpy(slots + i * sizeof(Slot), &s, sizeof(Slot));
+	});
+
+	TableFileHeader header = {};
+	header.kind = TableFileHeader::HASH;
+	header.keySize = sizeof(K);
+	header.valueSize = sizeof(V);
+	header.count = table.size();
+	header.capacity = capacity;
+	table_file::write(path, header, payload);
+}
+
+// Read-only SortedTable searched in a mapped file
+template <class K, class V>
+class MappedSortedTable {
+	static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>, "Table files hold trivially copyable keys and values");
+
+	MappedFile file;
+	const TableFileHeader* header;
+	const K* keys;
+	const V* vals;
+	size_t count;
+
+public:
+	explicit MappedSortedTable(const std::string& path) {
+		header = table_file::open(file, path, TableFileHeader::SORTED, sizeof(K), sizeof(V));
+		table_file::checkLayout(header->capacity == header->count
+			&& header->payloadBytes == table_file::sortedBytes(size_t(header->count), sizeof(K), sizeof(V)), path);
+		const uint8_t* payload = file.data() + sizeof(TableFileHeader);
+		count = size_t(header->count);
+		keys = reinterpret_cast<const K*>(payload);
+		vals = reinterpret_cast<const V*>(payload + table_file::sortedValuesOffset(count, sizeof(K)));
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	// Reads the whole payload and compares its checksum
+	bool verify() const {
+		return checksum64(file.data() + sizeof(TableFileHeader), size_t(header->payloadBytes)) == header->checksum;
+	}
+
+	const V* find(const K& key) const {
+		size_t k = count ? eytzingerLowerBound(keys, count, key) : 0;
+		return (k != 0 && !(key < keys[k])) ? &vals[k - 1] : nullptr;
+	}
+
+	// f(key, value) for every entry in ascending key order
+	template <class F>
+	void for_each(F f) const {
+		eytzingerInOrder(count, [&](size_t k) { f(keys[k], vals[k - 1]); });
+	}
+};
+
+// Read-only HashTable searched in a mapped file
+template <class K, class V, class Hash = TableHash<K>>
+class MappedHashTable {
+	static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>, "Table files hold trivially copyable keys and values");
+	typedef TableFileSlot<K, V> Slot;
+
+	MappedFile file;
+	const TableFileHeader* header;
+	const uint8_t* ctrl;
+	const Slot* slots;
+	size_t capacity;
+	Hash hasher;
+
+public:
+	explicit MappedHashTable(const std::string& path) {
+		header = table_file::open(file, path, TableFileHeader::HASH, sizeof(K), sizeof(V));
+		capacity = size_t(header->capacity);
+		table_file::checkLayout(capacity >= SwissControl::GROUP && std::has_single_bit(capacity)
+			&& header->count <= SwissControl::maxLoad(capacity)
+			&& header->payloadBytes == table_file::hashBytes(capacity, sizeof(Slot)), path);
+		ctrl = file.data() + sizeof(TableFileHeader);
+		slots = reinterpret_cast<const Slot*>(ctrl + table_file::hashSlotsOffset(capacity));
+	}
+
+	size_t size() const { return size_t(header->count); }
+	bool empty() const { return header->count == 0; }
+
+	// Reads the whole payload and compares its checksum
+	bool verify() const {
+		return checksum64(file.data() + sizeof(TableFileHeader), size_t(header->payloadBytes)) == header->checksum;
+	}
+
+	const V* find(const K& key) const {
+		size_t i = SwissControl::find(ctrl, capacity, hasher(key), [&](size_t j) { return slots[j].key == key; });
+		return i != SwissControl::NONE ? &slots[i].value : nullptr;
+	}
+
+	// f(key, value) for every entry, in slot order
+	template <class F>
+	void for_each(F f) const {
+		for (size_t i = 0; i < capacity; ++i)
+			if (ctrl[i] < SwissControl::EMPTY)
+				f(slots[i].key, slots[i].value);
+	}
+};
+
+#endif
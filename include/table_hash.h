@@ -0,0 +1,41 @@
+#ifndef __TABLE_HASH_H__
+#define __TABLE_HASH_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Finalizer of MurmurHash3: every input bit affects every output bit
+inline uint64_t hashMix(uint64_t x) {
+	x ^= x >> 33;
+	x *= 0xFF51AFD7ED558CCDull;
+	x ^= x >> 33;
+	x *= 0xC4CEB9FE1A85EC53ull;
+	x ^= x >> 33;
+	return x;
+}
+
+// Default hash of the tables. std::hash of an integer is the identity on
+// the common standard libraries, while the tables take bits from both ends
+// of the hash, so its result is mixed first.
+template <class K>
+struct TableHash {
+	size_t operator()(const K& key) const {
+		return size_t(hashMix(uint64_t(std::hash<K>()(key))));
+	}
+};
+
+// Strings hash through std::string_view, and the hash is transparent, so
+// tables can be searched with a string_view without building a std::string
+template <>
+struct TableHash<std::string> {
+	typedef void is_transparent;
+
+	size_t operator()(std::string_view key) const {
+		return size_t(hashMix(uint64_t(std::hash<std::string_view>()(key))));
+	}
+};
+
+#endif
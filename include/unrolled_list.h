@@ -0,0 +1,374 @@
+#ifndef __UNROLLED_LIST_H__
+#define __UNROLLED_LIST_H__
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include "pool.h"
+
+// Singly linked list that keeps up to K elements per node, so sequential
+// traversal (find, ==, <<, size) touches one heap node per K elements.
+// The interface follows List<T>, with positions expressed as Iterator instead
+// of Node*: insert/erase work on the element after the given position.
+template <class T, int K = 16, class Alloc = PoolAllocator<T>>
+class UnrolledList {
+	static_assert(K >= 2, "UnrolledList needs at least two elements per node");
+
+public:
+	struct Node {
+		T data[K];
+		int count;
+		Node* next;
+		Node() : count(0), next(nullptr) {}
+	};
+
+	class Iterator {
+		Node* node;
+		int index;
+
+		friend class UnrolledList;
+
+	public:
+		Iterator(Node* n = nullptr, int i = 0) : node(n), index(i) {}
+
+		Iterator& operator++() {
+			if (!node)
+				throw std::out_of_range("Out of range");
+
+			if (++index == node->count) {
+				node = node->next;
+				index = 0;
+			}
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator copy(*this);
+			++(*this);
+			return copy;
+		}
+
+		T& operator*() const {
+			if (!node)
+				throw std::out_of_range("Out of range");
+
+			return node->data[index];
+		}
+
+		T* operator->() const {
+			if (!node)
+				throw std::out_of_range("Out of range");
+
+			return &node->data[index];
+		}
+
+		friend bool operator==(const Iterator& it1, const Iterator& it2) {
+			return it1.node == it2.node && it1.index == it2.index;
+		}
+
+		friend bool operator!=(const Iterator& it1, const Iterator& it2) {
+			return !(it1 == it2);
+		}
+	};
+
+private:
+	using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+	Node* first;
+	int count;
+	NodeAlloc alloc;
+
+	Node* create_node(Node* next) {
+		Node* node = NodeTraits::allocate(alloc, 1);
+		try {
+			NodeTraits::construct(alloc, node);
+		}
+		catch (...) {
+			NodeTraits::deallocate(alloc, node, 1);
+			throw;
+		}
+		node->next = next;
+		return node;
+	}
+
+	void destroy_node(Node* node) noexcept {
+		NodeTraits::destroy(alloc, node);
+		NodeTraits::deallocate(alloc, node, 1);
+	}
+
+	// Puts value at position index of node, splitting the node when full
+	Iterator insert_at(Node* node, int index, const T& value) {
+		if (node->count == K) {
+			Node* tail = create_node(node->next);
+			int half = K / 2;
+			for (int i = half; i < K; ++i)
+				tail->data[i - half] = node->data[i];
+			tail->count = K - half;
+			node->count = half;
+			node->next = tail;
+
+			if (index > half) {
+				node = tail;
+				index -= half;
+			}
+		}
+
+		for (int i = node->count; i > index; --i)
+			node->data[i] = node->data[i - 1];
+		node->data[index] = value;
+		node->count++;
+		count++;
+
+		return Iterator(node, index);
+	}
+
+	// Removes element index of node; prev is the node before it (or nullptr)
+	Iterator erase_at(Node* prev, Node* node, int index) {
+		for (int i = index + 1; i < node->count; ++i)
+			node->data[i - 1] = node->data[i];
+		node->count--;
+		count--;
+
+		if (node->count == 0) {
+			Node* next = node->next;
+			if (prev)
+				prev->next = next;
+			else
+				first = next;
+			destroy_node(node);
+			return Iterator(next, 0);
+		}
+
+		// keep nodes at least half full by pulling in a small successor
+		Node* next = node->next;
+		if (next && node->count + next->count <= K) {
+			for (int i = 0; i < next->count; ++i)
+				node->data[node->count + i] = next->data[i];
+			node->count += next->count;
+			node->next = next->next;
+			destroy_node(next);
+		}
+
+		if (index == node->count)
+			return Iterator(node->next, 0);
+		return Iterator(node, index);
+	}
+
+	// Copies other into this empty list. Each node is linked before it is
+	// filled, so if a node or an element copy fails, clear() frees every
+	// node so far and the list is left empty.
+	void copy_from(const UnrolledList& other) {
+		try {
+			Node** tail = &first;
+			for (Node* current = other.first; current != nullptr; current = current->next) {
+				Node* node = create_node(nullptr);
+				*tail = node;
+				tail = &node->next;
+				for (int i = 0; i < current->count; ++i)
+					node->data[i] = current->data[i];
+				node->count = current->count;
+			}
+		}
+		catch (...) {
+			clear();
+			throw;
+		}
+		count = other.count;
+	}
+
+public:
+
+	UnrolledList() : first(nullptr), count(0) {}
+	UnrolledList(int n, T deflt = T()) : first(nullptr), count(0) {
+		if (n < 0)
+			throw std::invalid_argument("List cant have a negative size");
+
+		try {
+			Node** tail = &first;
+			while (n > 0) {
+				Node* node = create_node(nullptr);
+				*tail = node;
+				tail = &node->next;
+				int take = n < K ? n : K;
+				for (int i = 0; i < take; ++i)
+					node->data[i] = deflt;
+				node->count = take;
+				count += take;
+				n -= take;
+			}
+		}
+		catch (...) {
+			// the destructor doesn't run for an unfinished constructor
+			clear();
+			throw;
+		}
+	}
+
+	UnrolledList(const UnrolledList& other) : first(nullptr), count(0), alloc(NodeTraits::select_on_container_copy_construction(other.alloc)) {
+		copy_from(other);
+	}
+
+	~UnrolledList() {
+		clear();
+	}
+
+	UnrolledList& operator=(const UnrolledList& other) {
+		if (this == &other)
+			return *this;
+
+		clear();
+		copy_from(other);
+
+		return *this;
+	}
+
+	void clear() {
+		Node* current = first;
+		while (current != nullptr) {
+			Node* next = current->next;
+			destroy_node(current);
+			current = next;
+		}
+		first = nullptr;
+		count = 0;
+	}
+
+	void print() {
+		std::cout << *this << std::endl;
+	}
+
+	bool operator==(const UnrolledList& other) const noexcept {
+		if (count != other.count)
+			return false;
+
+		Node* n1 = first;
+		Node* n2 = other.first;
+		int i1 = 0, i2 = 0;
+
+		while (n1 != nullptr && n2 != nullptr) {
+			// compare the overlapping run of both nodes in one go
+			int run = n1->count - i1 < n2->count - i2 ? n1->count - i1 : n2->count - i2;
+			for (int i = 0; i < run; ++i)
+				if (n1->data[i1 + i] != n2->data[i2 + i])
+					return false;
+
+			i1 += run;
+			i2 += run;
+			if (i1 == n1->count) {
+				n1 = n1->next;
+				i1 = 0;
+			}
+			if (i2 == n2->count) {
+				n2 = n2->next;
+				i2 = 0;
+			}
+		}
+		return n1 == nullptr && n2 == nullptr;
+	}
+
+	bool operator!=(const UnrolledList& other) const noexcept {
+		return !(*this == other);
+	}
+
+	T& operator[](int index) {
+		return *get_index(index);
+	}
+
+	int size() const noexcept {
+		return count;
+	}
+
+	bool empty() const noexcept {
+		return count == 0;
+	}
+
+	Iterator get_index(int index) {
+		if (index < 0 || index >= count)
+			throw std::out_of_range("Index out of range");
+
+		Node* current = first;
+		while (index >= current->count) {
+			index -= current->count;
+			current = current->next;
+		}
+
+		return Iterator(current, index);
+	}
+
+	// Inserts value after prev, returns its position
+	Iterator insert(T value, Iterator prev) {
+		if (!prev.node)
+			throw std::out_of_range("Can't insert after end");
+
+		return insert_at(prev.node, prev.index + 1, value);
+	}
+
+	Iterator insert_front(T value) {
+		if (!first)
+			first = create_node(nullptr);
+
+		return insert_at(first, 0, value);
+	}
+
+	// Removes the element after prev, returns the position that follows it
+	Iterator erase(Iterator prev) {
+		if (!prev.node)
+			throw std::out_of_range("Can't erase after end");
+
+		if (prev.index + 1 < prev.node->count)
+			return erase_at(nullptr, prev.node, prev.index + 1);
+
+		Node* next = prev.node->next;
+		if (!next)
+			throw std::out_of_range("No element after the given position");
+
+		return erase_at(prev.node, next, 0);
+	}
+
+	Iterator erase_front() {
+		if (!first)
+			throw std::out_of_range("Can't erase from empty list");
+
+		return erase_at(nullptr, first, 0);
+	}
+
+	Iterator find(const T& value) const {
+		for (Node* current = first; current != nullptr; current = current->next)
+			for (int i = 0; i < current->count; ++i)
+				if (current->data[i] == value)
+					return Iterator(current, i);
+
+		return Iterator();
+	}
+
+	Iterator get_first() noexcept {
+		return Iterator(first, 0);
+	}
+
+	friend std::istream& operator>>(std::istream& istr, UnrolledList& other) {
+		for (Node* current = other.first; current != nullptr; current = current->next)
+			for (int i = 0; i < current->count; ++i)
+				istr >> current->data[i];
+
+		return istr;
+	}
+
+	friend std::ostream& operator<<(std::ostream& ostr, const UnrolledList& other) {
+		for (Node* current = other.first; current != nullptr; current = current->next)
+			for (int i = 0; i < current->count; ++i)
+				ostr << current->data[i] << ' ';
+
+		return ostr;
+	}
+
+	Iterator begin() {
+		return Iterator(first, 0);
+	}
+
+	Iterator end() {
+		return Iterator();
+	}
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef __UNSORTED_TABLE_H__
+#define __UNSORTED_TABLE_H__
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "simd_match.h"
+#include "table_hash.h"
+
+// Unordered table for small sizes: entries sit in insertion order in three
+// parallel arrays. The one-byte fingerprints (top byte of the hash) are
+// scanned 32 at a time with byte compares, and keys are compared only on
+// a fingerprint hit, which for a miss happens about once in 256 entries.
+// Erase moves the last entry into the hole, so all operations are a scan
+// plus O(1) work.
+template <class K, class V, class Hash = TableHash<K>>
+class UnsortedTable {
+	std::vector<uint8_t> tags;
+	std::vector<K> keys;
+	std::vector<V> vals;
+	Hash hasher;
+
+	static constexpr size_t NONE = ~size_t(0);
+
+	static uint8_t tagOf(size_t h) { return uint8_t(h >> (8 * sizeof(size_t) - 8)); }
+
+	// Checks the fingerprint hits in mask, block starts at index base
+	size_t checkHits(uint32_t mask, size_t base, const K& key) const {
+		for (; mask; mask &= mask - 1) {
+			size_t i = base + size_t(std::countr_zero(mask));
+			if (keys[i] == key)
+				return i;
+		}
+		return NONE;
+	}
+
+	size_t indexOf(const K& key) const {
+		uint8_t tag = tagOf(hasher(key));
+		const uint8_t* t = tags.data();
+		size_t n = tags.size(), i = 0, found = NONE;
+
+		for (; i + 32 <= n; i += 32)
+			if ((found = checkHits(matchByte32(t + i, tag), i, key)) != NONE)
+				return found;
+		if (i + 16 <= n) {
+			if ((found = checkHits(matchByte16(t + i, tag), i, key)) != NONE)
+				return found;
+			i += 16;
+		}
+		for (; i < n; ++i)
+			if (t[i] == tag && keys[i] == key)
+				return i;
+		return NONE;
+	}
+
+public:
+	UnsortedTable() {}
+
+	size_t size() const { return keys.size(); }
+	bool empty() const { return keys.empty(); }
+
+	void clear() {
+		tags.clear();
+		keys.clear();
+		vals.clear();
+	}
+
+	void reserve(size_t n) {
+		tags.reserve(n);
+		keys.reserve(n);
+		vals.reserve(n);
+	}
+
+	V* find(const K& key) {
+		size_t i = indexOf(key);
+		return i != NONE ? &vals[i] : nullptr;
+	}
+
+	const V* find(const K& key) const {
+		size_t i = indexOf(key);
+		return i != NONE ? &vals[i] : nullptr;
+	}
+
+	// False (and no change) if the key is already present
+	bool insert(const K& key, const V& value) {
+		if (indexOf(key) != NONE)
+			return false;
+		// skip the 1, 2, 4, 8 growth steps of all three arrays
+		if (keys.capacity() == 0)
+			reserve(16);
+		tags.push_back(tagOf(hasher(key)));
+		keys.push_back(key);
+		vals.push_back(value);
+		return true;
+	}
+
+	bool erase(const K& key) {
+		size_t i = indexOf(key);
+		if (i == NONE)
+			return false;
+		size_t last = keys.size() - 1;
+		if (i != last) {
+			tags[i] = tags[last];
+			keys[i] = std::move(keys[last]);
+			vals[i] = std::move(vals[last]);
+		}
+		tags.pop_back();
+		keys.pop_back();
+		vals.pop_back();
+		return true;
+	}
+
+	// f(key, value) for every entry, in no particular order
+	template <class F>
+	void for_each(F f) const {
+		for (size_t i = 0; i < keys.size(); ++i)
+			f(keys[i], vals[i]);
+	}
+
+	template <class F>
+	void for_each(F f) {
+		for (size_t i = 0; i < keys.size(); ++i)
+			f(static_cast<const K&>(keys[i]), vals[i]);
+	}
+};
+
+#endif
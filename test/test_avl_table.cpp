@@ -0,0 +1,269 @@
+#include "avl_table.h"
+#include <gtest.h>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// AVL trees with n nodes are at most ~1.44 log2(n + 2) high
+static bool heightIsLogarithmic(int height, size_t n)
+{
+	return height <= 1.4405 * std::log2(double(n) + 2) - 0.3277;
+}
+
+TEST(AVLTable, empty_table_finds_nothing)
+{
+	AVLTable<int, int> t;
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(t.height(), 0);
+	EXPECT_EQ(t.find(0), nullptr);
+	EXPECT_FALSE(t.erase(0));
+	EXPECT_TRUE(t.begin() == t.end());
+}
+
+TEST(AVLTable, sequential_inserts_stay_balanced)
+{
+	AVLTable<int, int> t;
+	for (int i = 0; i < 10000; ++i)
+		ASSERT_TRUE(t.insert(i, -i));
+
+	EXPECT_FALSE(t.insert(5, 0));
+	EXPECT_EQ(t.size(), 10000u);
+	EXPECT_TRUE(heightIsLogarithmic(t.height(), t.size()));
+	for (int i = 0; i < 10000; ++i)
+		ASSERT_EQ(*t.find(i), -i);
+}
+
+TEST(AVLTable, matches_std_map_under_random_inserts_and_erases)
+{
+	AVLTable<int, std::string> t;
+	std::map<int, std::string> ref;
+	for (int i = 0; i < 20000; ++i) {
+		int k = int((i * 2654435761u) % 4099);
+		if (i % 3 == 2) {
+			ASSERT_EQ(t.erase(k), ref.erase(k) == 1);
+		}
+		else {
+			ASSERT_EQ(t.insert(k, std::to_string(i)), ref.insert(std::make_pair(k, std::to_string(i))).second);
+		}
+	}
+
+	ASSERT_EQ(t.size(), ref.size());
+	EXPECT_TRUE(heightIsLogarithmic(t.height(), t.size()));
+	std::map<int, std::string>::const_iterator it = ref.begin();
+	for (AVLTable<int, std::string>::Iterator n = t.begin(); n != t.end(); ++n, ++it) {
+		ASSERT_EQ(n->key, it->first);
+		ASSERT_EQ(n->value, it->second);
+	}
+	EXPECT_TRUE(it == ref.end());
+}
+
+TEST(AVLTable, iterators_change_values_but_not_keys)
+{
+	typedef AVLTable<int, int> Table;
+	static_assert(std::is_same_v<decltype((Table::Iterator()->key)), const int&>, "keys are read-only");
+	static_assert(std::is_same_v<decltype((Table::Iterator()->value)), int&>, "values are writable");
+	static_assert(std::is_same_v<decltype((Table::ConstIterator()->value)), const int&>, "not through a const table");
+
+	Table t;
+	for (int i = 0; i < 100; ++i)
+		t.insert(i, 0);
+	for (Table::Iterator it = t.begin(); it != t.end(); ++it)
+		it->value = it->key * 2;
+	for (int i = 0; i < 100; ++i)
+		ASSERT_EQ(*t.find(i), i * 2);
+}
+
+TEST(AVLTable, erase_keeps_other_entries_in_place)
+{
+	AVLTable<int, int> t;
+	for (int i = 0; i < 1000; ++i)
+		t.insert(i, i);
+	// erase nodes with two children; their successors must not move
+	for (int k = 0; k < 1000; k += 7) {
+		AVLTable<int, int>::Iterator next = t.lower_bound(k + 1);
+		ASSERT_TRUE(next != t.end());
+		int nextKey = next->key;
+		const int* value = &next->value;
+		ASSERT_TRUE(t.erase(k));
+		ASSERT_EQ(t.find(nextKey), value);
+	}
+	EXPECT_TRUE(heightIsLogarithmic(t.height(), t.size()));
+	size_t r = 0;
+	for (AVLTable<int, int>::Iterator it = t.begin(); it != t.end(); ++it, ++r) {
+		ASSERT_NE(it->key % 7, 0);
+		ASSERT_EQ(t.rank(it->key), r);
+	}
+	EXPECT_EQ(r, t.size());
+}
+
+TEST(AVLTable, bulk_build_is_perfectly_balanced)
+{
+	std::vector<std::pair<int, int>> items;
+	for (int i = 0; i < 1023; ++i)
+		items.push_back(std::make_pair(i * 2, i));
+	AVLTable<int, int> t(items);
+
+	EXPECT_EQ(t.size(), 1023u);
+	EXPECT_EQ(t.height(), 10);
+	EXPECT_EQ(*t.find(500), 250);
+	EXPECT_TRUE(t.insert(1, 1));
+	EXPECT_TRUE(t.erase(0));
+}
+
+TEST(AVLTable, bulk_build_rejects_unsorted_input)
+{
+	std::vector<std::pair<int, int>> items = { { 2, 0 }, { 1, 0 } };
+
+	ASSERT_ANY_THROW((AVLTable<int, int>(items)));
+}
+
+TEST(AVLTable, range_is_half_open)
+{
+	AVLTable<int, int> t;
+	for (int i = 0; i < 100; ++i)
+		t.insert(i * 10, i);
+
+	std::vector<int> keys;
+	t.range(25, 70, [&](const int& k, const int&) { keys.push_back(k); });
+
+	std::vector<int> expected = { 30, 40, 50, 60 };
+	EXPECT_EQ(keys, expected);
+	EXPECT_EQ(t.lower_bound(25)->key, 30);
+	EXPECT_TRUE(t.lower_bound(1000) == t.end());
+}
+
+TEST(AVLTable, copy_is_independent)
+{
+	AVLTable<int, int> a;
+	for (int i = 0; i < 50; ++i)
+		a.insert(i, i);
+	AVLTable<int, int> b(a);
+
+	b.erase(10);
+	*b.find(20) = -1;
+
+	EXPECT_EQ(*a.find(10), 10);
+	EXPECT_EQ(*a.find(20), 20);
+	EXPECT_EQ(b.size(), 49u);
+
+	AVLTable<int, int> c(std::move(b));
+	EXPECT_EQ(c.size(), 49u);
+	EXPECT_TRUE(b.empty());
+}
+
+TEST(AVLTable, select_and_rank_follow_inserts_and_erases)
+{
+	AVLTable<int, int> t;
+	std::map<int, int> ref;
+	for (int i = 0; i < 5000; ++i) {
+		int k = int((i * 2654435761u) % 1021);
+		if (i % 3 == 2) {
+			t.erase(k);
+			ref.erase(k);
+		}
+		else {
+			t.insert(k, i);
+			ref.insert(std::make_pair(k, i));
+		}
+	}
+
+	size_t r = 0;
+	for (std::map<int, int>::const_iterator it = ref.begin(); it != ref.end(); ++it, ++r) {
+		AVLTable<int, int>::Iterator n = t.select(r);
+		ASSERT_TRUE(n != t.end());
+		ASSERT_EQ(n->key, it->first);
+		ASSERT_EQ(t.rank(it->first), r);
+		// keys between entries rank like their successor
+		ASSERT_EQ(t.rank(it->first + 1), r + 1);
+	}
+	EXPECT_TRUE(t.select(ref.size()) == t.end());
+	EXPECT_EQ(t.rank(-1), 0u);
+	EXPECT_EQ(t.rank(5000), t.size());
+}
+
+TEST(AVLTable, select_after_bulk_build_and_copy)
+{
+	std::vector<std::pair<int, int>> items;
+	for (int i = 0; i < 1000; ++i)
+		items.push_back(std::make_pair(3 * i, i));
+	AVLTable<int, int> t(items);
+	AVLTable<int, int> copy(t);
+
+	for (size_t k = 0; k < 1000; ++k) {
+		ASSERT_EQ(t.select(k)->key, int(3 * k));
+		ASSERT_EQ(copy.select(k)->value, int(k));
+	}
+	EXPECT_EQ(copy.rank(1500), 500u);
+}
+
+// Value whose copy throws once copiesLeft runs out, counting live objects
+struct ThrowingCopy {
+	static int copiesLeft;
+	static int live;
+	int v;
+
+	ThrowingCopy(int v) : v(v) { ++live; }
+	ThrowingCopy(const ThrowingCopy& other) : v(other.v) {
+		if (copiesLeft-- == 0)
+			throw std::runtime_error("copy failed");
+		++live;
+	}
+	~ThrowingCopy() { --live; }
+};
+
+int ThrowingCopy::copiesLeft = -1;
+int ThrowingCopy::live = 0;
+
+TEST(AVLTable, copy_that_throws_frees_the_partial_tree)
+{
+	{
+		AVLTable<int, ThrowingCopy> t;
+		for (int i = 0; i < 200; ++i)
+			t.insert(i, ThrowingCopy(i));
+		int before = ThrowingCopy::live;
+
+		// fail at the first, a middle and the last node of the copy
+		for (int failAt : { 0, 57, 120, 199 }) {
+			ThrowingCopy::copiesLeft = failAt;
+			EXPECT_THROW((AVLTable<int, ThrowingCopy>(t)), std::runtime_error);
+			EXPECT_EQ(ThrowingCopy::live, before);
+		}
+		ThrowingCopy::copiesLeft = -1;
+		AVLTable<int, ThrowingCopy> copy(t);
+		EXPECT_EQ(copy.size(), 200u);
+		EXPECT_EQ(copy.find(120)->v, 120);
+	}
+	EXPECT_EQ(ThrowingCopy::live, 0);
+}
+
+TEST(AVLTable, bulk_build_that_throws_frees_the_partial_tree)
+{
+	{
+		std::vector<std::pair<int, ThrowingCopy>> items;
+		for (int i = 0; i < 100; ++i)
+			items.push_back(std::make_pair(i, ThrowingCopy(i)));
+		int before = ThrowingCopy::live;
+
+		for (int failAt : { 0, 31, 99 }) {
+			ThrowingCopy::copiesLeft = failAt;
+			// the by-value argument takes no copy when moved in
+			std::vector<std::pair<int, ThrowingCopy>> moved;
+			{
+				int saved = ThrowingCopy::copiesLeft;
+				ThrowingCopy::copiesLeft = -1;
+				moved = items;
+				ThrowingCopy::copiesLeft = saved;
+			}
+			EXPECT_THROW((AVLTable<int, ThrowingCopy>(std::move(moved))), std::runtime_error);
+			EXPECT_EQ(ThrowingCopy::live, before);
+		}
+		ThrowingCopy::copiesLeft = -1;
+	}
+	EXPECT_EQ(ThrowingCopy::live, 0);
+}
@@ -0,0 +1,147 @@
+#include "btree_table.h"
+#include <gtest.h>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Four entries per node, so that a few hundred keys make a deep tree
+typedef BTreeTable<int, int, 32> SmallNodeTable;
+
+TEST(BTreeTable, empty_table_finds_nothing)
+{
+	BTreeTable<int, int> t;
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(t.height(), 1);
+	EXPECT_EQ(t.find(0), nullptr);
+	EXPECT_FALSE(t.erase(0));
+	EXPECT_TRUE(t.isValid());
+}
+
+TEST(BTreeTable, moved_from_and_cleared_tables_stay_usable)
+{
+	static_assert(std::is_nothrow_move_constructible_v<BTreeTable<int, int>>, "moves never allocate");
+	BTreeTable<int, int> a;
+	for (int i = 0; i < 100; ++i)
+		a.insert(i, i);
+
+	BTreeTable<int, int> b(std::move(a));
+	EXPECT_EQ(b.size(), 100u);
+	EXPECT_TRUE(a.empty());
+	EXPECT_EQ(a.find(5), nullptr);
+	EXPECT_FALSE(a.erase(5));
+	EXPECT_TRUE(a.isValid());
+	size_t visited = 0;
+	a.for_each([&](const int&, const int&) { ++visited; });
+	a.range(0, 100, [&](const int&, const int&) { ++visited; });
+	EXPECT_EQ(visited, 0u);
+
+	BTreeTable<int, int> c(a);
+	EXPECT_TRUE(c.insert(1, 1));
+	EXPECT_TRUE(a.insert(5, 50));
+	EXPECT_EQ(*a.find(5), 50);
+
+	b.clear();
+	EXPECT_TRUE(b.empty());
+	EXPECT_EQ(b.find(5), nullptr);
+	EXPECT_TRUE(b.insert(5, 5));
+	EXPECT_TRUE(b.isValid());
+}
+
+TEST(BTreeTable, sequential_inserts_split_nodes)
+{
+	SmallNodeTable t;
+	for (int i = 0; i < 10000; ++i)
+		ASSERT_TRUE(t.insert(i, -i));
+
+	EXPECT_FALSE(t.insert(5, 0));
+	EXPECT_EQ(t.size(), 10000u);
+	EXPECT_TRUE(t.isValid());
+	EXPECT_GT(t.height(), 5);
+	for (int i = 0; i < 10000; ++i)
+		ASSERT_EQ(*t.find(i), -i);
+}
+
+TEST(BTreeTable, matches_std_map_under_random_inserts_and_erases)
+{
+	SmallNodeTable t;
+	std::map<int, int> ref;
+	for (int i = 0; i < 30000; ++i) {
+		int k = int((i * 2654435761u) % 2053);
+		if (i % 3 == 2) {
+			ASSERT_EQ(t.erase(k), ref.erase(k) == 1);
+		}
+		else {
+			ASSERT_EQ(t.insert(k, i), ref.insert(std::make_pair(k, i)).second);
+		}
+		if (i % 1000 == 0) {
+			ASSERT_TRUE(t.isValid());
+		}
+	}
+
+	ASSERT_TRUE(t.isValid());
+	ASSERT_EQ(t.size(), ref.size());
+	std::map<int, int>::const_iterator it = ref.begin();
+	t.for_each([&](const int& k, const int& v) {
+		ASSERT_EQ(k, it->first);
+		ASSERT_EQ(v, it->second);
+		++it;
+	});
+	EXPECT_TRUE(it == ref.end());
+}
+
+TEST(BTreeTable, erase_everything_shrinks_to_a_leaf)
+{
+	SmallNodeTable t;
+	for (int i = 0; i < 1000; ++i)
+		t.insert(i, i);
+	for (int i = 0; i < 1000; i += 2)
+		ASSERT_TRUE(t.erase(i));
+	ASSERT_TRUE(t.isValid());
+	for (int i = 999; i >= 0; i -= 2)
+		ASSERT_TRUE(t.erase(i));
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(t.height(), 1);
+	EXPECT_TRUE(t.isValid());
+	EXPECT_TRUE(t.insert(7, 7));
+}
+
+TEST(BTreeTable, range_is_half_open)
+{
+	BTreeTable<int, int> t;
+	for (int i = 0; i < 1000; ++i)
+		t.insert(2 * i, i);
+
+	std::vector<int> keys;
+	t.range(101, 121, [&](const int& k, const int&) { keys.push_back(k); });
+	EXPECT_EQ(keys, (std::vector<int>{ 102, 104, 106, 108, 110, 112, 114, 116, 118, 120 }));
+
+	keys.clear();
+	t.range(1990, 5000, [&](const int& k, const int&) { keys.push_back(k); });
+	EXPECT_EQ(keys, (std::vector<int>{ 1990, 1992, 1994, 1996, 1998 }));
+}
+
+TEST(BTreeTable, copy_is_independent)
+{
+	BTreeTable<std::string, int> a;
+	for (int i = 0; i < 500; ++i)
+		a.insert(std::to_string(i), i);
+
+	BTreeTable<std::string, int> b(a);
+	b.erase("42");
+	b.insert("x", 1);
+	EXPECT_EQ(*a.find("42"), 42);
+	EXPECT_EQ(a.find("x"), nullptr);
+	EXPECT_EQ(b.size(), 500u);
+	EXPECT_TRUE(b.isValid());
+
+	size_t visited = 0;
+	b.for_each([&](const std::string&, int&) { ++visited; });
+	EXPECT_EQ(visited, 500u);
+	a = std::move(b);
+	EXPECT_EQ(*a.find("x"), 1);
+}
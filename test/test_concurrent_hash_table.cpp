@@ -0,0 +1,110 @@
+#include "concurrent_hash_table.h"
+#include <gtest.h>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+TEST(ConcurrentHashTable, rounds_shards_to_power_of_two)
+{
+	EXPECT_EQ((ConcurrentHashTable<int, int>(1).shardTotal()), 1u);
+	EXPECT_EQ((ConcurrentHashTable<int, int>(5).shardTotal()), 8u);
+	EXPECT_ANY_THROW((ConcurrentHashTable<int, int>(0)));
+}
+
+TEST(ConcurrentHashTable, single_thread_operations)
+{
+	ConcurrentHashTable<int, int> t(4);
+	int v = 0;
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_FALSE(t.find(1, v));
+	for (int i = 0; i < 1000; ++i)
+		ASSERT_TRUE(t.insert(i, i));
+	EXPECT_FALSE(t.insert(7, 0));
+	EXPECT_EQ(t.size(), 1000u);
+
+	EXPECT_TRUE(t.find(7, v));
+	EXPECT_EQ(v, 7);
+	EXPECT_FALSE(t.assign(7, 70));
+	EXPECT_TRUE(t.assign(1000, 1));
+	EXPECT_TRUE(t.update(7, [](int& x) { x += 1; }));
+	EXPECT_FALSE(t.update(-1, [](int& x) { x += 1; }));
+	EXPECT_TRUE(t.find(7, v));
+	EXPECT_EQ(v, 71);
+
+	EXPECT_TRUE(t.erase(7));
+	EXPECT_FALSE(t.contains(7));
+	EXPECT_EQ(t.size(), 1000u);
+
+	long sum = 0;
+	t.for_each([&](const int& k, const int&) { sum += k; });
+	EXPECT_EQ(sum, 999L * 1000 / 2 - 7 + 1000);
+	t.clear();
+	EXPECT_TRUE(t.empty());
+}
+
+TEST(ConcurrentHashTable, string_view_lookup)
+{
+	ConcurrentHashTable<std::string, int> t;
+	t.insert("alpha", 1);
+	int v = 0;
+
+	std::string_view text = "alpha beta";
+	EXPECT_TRUE(t.find(text.substr(0, 5), v));
+	EXPECT_EQ(v, 1);
+	EXPECT_FALSE(t.contains(text.substr(6)));
+	EXPECT_TRUE(t.erase(text.substr(0, 5)));
+}
+
+TEST(ConcurrentHashTable, concurrent_inserts_of_disjoint_keys)
+{
+	ConcurrentHashTable<int, int> t(8);
+	const int threads = 4, perThread = 20000;
+	std::vector<std::thread> workers;
+	for (int w = 0; w < threads; ++w)
+		workers.push_back(std::thread([&t, w] {
+			for (int i = 0; i < perThread; ++i)
+				t.insert(w * perThread + i, w);
+		}));
+	for (std::thread& th : workers)
+		th.join();
+
+	EXPECT_EQ(t.size(), size_t(threads * perThread));
+	int v = -1;
+	for (int k = 0; k < threads * perThread; ++k) {
+		ASSERT_TRUE(t.find(k, v));
+		ASSERT_EQ(v, k / perThread);
+	}
+}
+
+TEST(ConcurrentHashTable, concurrent_updates_and_reads)
+{
+	ConcurrentHashTable<int, long> t(4);
+	const int keys = 64, threads = 4, rounds = 5000;
+	for (int k = 0; k < keys; ++k)
+		t.insert(k, 0);
+
+	std::atomic<bool> torn(false);
+	std::vector<std::thread> workers;
+	for (int w = 0; w < threads; ++w)
+		workers.push_back(std::thread([&t, w] {
+			for (int r = 0; r < rounds; ++r)
+				t.update((r + w) % keys, [](long& x) { ++x; });
+		}));
+	workers.push_back(std::thread([&t, &torn] {
+		long v;
+		for (int r = 0; r < rounds; ++r)
+			if (!t.find(r % keys, v) || v < 0)
+				torn = true;
+	}));
+	for (std::thread& th : workers)
+		th.join();
+
+	long total = 0;
+	t.for_each([&](const int&, const long& x) { total += x; });
+	EXPECT_FALSE(torn);
+	EXPECT_EQ(total, long(threads) * rounds);
+}
@@ -0,0 +1,72 @@
+#include "cow_vector.h"
+#include "polynomial.h"
+#include <gtest.h>
+
+
+TEST(CowVector, empty_vector_owns_nothing)
+{
+	CowVector<int> v;
+
+	EXPECT_TRUE(v.empty());
+	EXPECT_EQ(v.useCount(), 0);
+}
+
+TEST(CowVector, copies_share_storage)
+{
+	CowVector<int> a(std::vector<int>(3, 7));
+	CowVector<int> b(a);
+
+	EXPECT_TRUE(a.sharesWith(b));
+	EXPECT_EQ(a.useCount(), 2);
+	EXPECT_EQ(&a.view(), &b.view());
+}
+
+TEST(CowVector, edit_detaches_shared_copy)
+{
+	CowVector<int> a(std::vector<int>(3, 7));
+	CowVector<int> b(a);
+
+	b.edit()[0] = 1;
+
+	EXPECT_FALSE(a.sharesWith(b));
+	EXPECT_EQ(a[0], 7);
+	EXPECT_EQ(b[0], 1);
+	EXPECT_EQ(a.useCount(), 1);
+}
+
+TEST(CowVector, edit_of_sole_owner_does_not_copy)
+{
+	CowVector<int> a(std::vector<int>(3, 7));
+	const int* before = a.view().data();
+
+	a.edit()[1] = 2;
+
+	EXPECT_EQ(a.view().data(), before);
+}
+
+TEST(CowVector, assignment_releases_old_block)
+{
+	CowVector<int> a(std::vector<int>(2, 1));
+	CowVector<int> b(a);
+	CowVector<int> c(std::vector<int>(1, 5));
+
+	b = c;
+
+	EXPECT_EQ(a.useCount(), 1);
+	EXPECT_EQ(c.useCount(), 2);
+	EXPECT_EQ(b, c);
+}
+
+TEST(CowVector, polynomial_copy_shares_terms_until_changed)
+{
+	Polynomial p = Polynomial::monomial(2, 1, 0, 0) + 1;
+	Polynomial q = p;
+
+	EXPECT_TRUE(p.sharesStorageWith(q));
+
+	q.addTerm(3, 0, 1, 0);
+
+	EXPECT_FALSE(p.sharesStorageWith(q));
+	EXPECT_EQ(p.size(), 2);
+	EXPECT_EQ(q.size(), 3);
+}
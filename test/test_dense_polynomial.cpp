@@ -0,0 +1,118 @@
+#include "dense_polynomial.h"
+#include "artans.h"
+#include <gtest.h>
+#include <sstream>
+
+
+static DensePolynomial sequence(size_t n, double scale)
+{
+	std::vector<double> c(n);
+	for (size_t i = 0; i < n; ++i)
+		c[i] = scale * double((i * 7919) % 13) - 6;
+	return DensePolynomial(c);
+}
+
+TEST(DensePolynomial, drops_trailing_zeros)
+{
+	std::vector<double> c = { 1, 2, 0, 0 };
+	DensePolynomial p(c);
+
+	EXPECT_EQ(p.degree(), 1);
+	EXPECT_EQ(DensePolynomial().degree(), -1);
+}
+
+TEST(DensePolynomial, round_trips_with_sparse)
+{
+	ArithmeticTranslator translator;
+	Polynomial sparse = translator.ToPolynomial("3*x^5 - x^2 + 7");
+
+	DensePolynomial dense(sparse);
+
+	EXPECT_EQ(dense.degree(), 5);
+	EXPECT_EQ(dense.coefficient(2), -1);
+	EXPECT_EQ(dense.toSparse(), sparse);
+}
+
+TEST(DensePolynomial, cant_convert_multivariate_polynomial)
+{
+	ASSERT_ANY_THROW(DensePolynomial(Polynomial::monomial(1, 1, 1, 0)));
+}
+
+TEST(DensePolynomial, can_add_and_subtract)
+{
+	DensePolynomial p = sequence(10, 1);
+	DensePolynomial q = sequence(4, 2);
+
+	EXPECT_EQ((p + q) - q, p);
+	EXPECT_TRUE((p - p).isZero());
+}
+
+TEST(DensePolynomial, can_evaluate)
+{
+	std::vector<double> c = { 1, -2, 3 };
+	DensePolynomial p(c);
+
+	EXPECT_EQ(p.evaluate(2), 9);
+}
+
+TEST(DensePolynomial, karatsuba_matches_schoolbook)
+{
+	DensePolynomial a = sequence(300, 1);
+	DensePolynomial b = sequence(170, 3);
+
+	DensePolynomial expected = DensePolynomial::multiply(a, b, DensePolynomial::MUL_SCHOOLBOOK);
+
+	// integer coefficients stay exact in Karatsuba
+	EXPECT_EQ(expected, DensePolynomial::multiply(a, b, DensePolynomial::MUL_KARATSUBA));
+}
+
+TEST(DensePolynomial, fft_matches_schoolbook)
+{
+	DensePolynomial a = sequence(1000, 0.5);
+	DensePolynomial b = sequence(777, 0.25);
+
+	DensePolynomial expected = DensePolynomial::multiply(a, b, DensePolynomial::MUL_SCHOOLBOOK);
+	DensePolynomial fft = DensePolynomial::multiply(a, b, DensePolynomial::MUL_FFT);
+
+	ASSERT_EQ(fft.degree(), expected.degree());
+	for (int i = 0; i <= expected.degree(); ++i)
+		EXPECT_NEAR(fft.coefficient(i), expected.coefficient(i), 1e-8);
+}
+
+TEST(DensePolynomial, multiplication_agrees_with_sparse)
+{
+	ArithmeticTranslator translator;
+	Polynomial sparse = translator.ToPolynomial("(x + 1)^60");
+	DensePolynomial base(translator.ToPolynomial("x + 1"));
+
+	DensePolynomial dense = base.pow(60);
+
+	EXPECT_EQ(dense.degree(), 60);
+	for (int i = 0; i <= 60; ++i)
+		EXPECT_NEAR(dense.coefficient(i) / sparse.coefficient(i, 0, 0), 1, 1e-12);
+}
+
+TEST(DensePolynomial, prints_like_sparse)
+{
+	std::vector<double> c = { 1, 0, 3 };
+	std::ostringstream out;
+	out << DensePolynomial(c);
+
+	EXPECT_EQ(out.str(), "3*x^2 + 1");
+}
+
+TEST(DensePolynomial, evaluates_at_many_points)
+{
+	DensePolynomial p = sequence(40, 0.1);
+	std::vector<double> xs, horner(90), estrin(90);
+	for (int i = 0; i < 90; ++i)
+		xs.push_back(i * 0.02 - 0.9);
+
+	p.evaluate(xs, horner);
+	p.evaluate(xs, estrin, MultiPointEval::ESTRIN);
+
+	for (int i = 0; i < 90; ++i) {
+		EXPECT_NEAR(horner[i], p.evaluate(xs[i]), 1e-12);
+		EXPECT_NEAR(estrin[i], p.evaluate(xs[i]), 1e-12);
+	}
+}
@@ -0,0 +1,235 @@
+#include "artans.h"
+#include "program_file.h"
+#include <gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+static std::string tempPath(const std::string& name) {
+	return (std::filesystem::temp_directory_path() / ("expression_program_" + name)).string();
+}
+
+TEST(ExpressionProgram, evaluates_like_calculator)
+{
+	ArithmeticTranslator translator;
+	const char* formulas[] = {
+		"(4 ^ 2) * (2 + (3 / (2 + 2))) + ((4 * 5) / (2 + 3))",
+		"1 - 2 - 3",
+		"2 ^ 3 ^ 2",
+		"-(3 + 4) * -2",
+		"-2 ^ 2",
+		"0.5 * 8 / 4",
+	};
+	for (const char* f : formulas) {
+		ExpressionProgram p = translator.ToProgram(f);
+		EXPECT_EQ(p.variableCount(), 0u);
+		EXPECT_DOUBLE_EQ(p.evaluate(std::vector<double>()), translator.ToPolynomial(f).coefficient(0, 0, 0)) << f;
+	}
+	EXPECT_EQ(translator.ToProgram("2 ^ 3 ^ 2").evaluate(std::vector<double>()), 512);
+	EXPECT_EQ(translator.ToProgram("-2 ^ 2").evaluate(std::vector<double>()), -4);
+}
+
+TEST(ExpressionProgram, variables_get_slots_in_order_of_appearance)
+{
+	ArithmeticTranslator translator;
+	ExpressionProgram p = translator.ToProgram("rate * (principal + rate) - x1 / principal");
+
+	ASSERT_EQ(p.variableCount(), 3u);
+	EXPECT_EQ(p.variable(0), "rate");
+	EXPECT_EQ(p.variable(1), "principal");
+	EXPECT_EQ(p.variable(2), "x1");
+	EXPECT_EQ(p.slotOf("x1"), 2u);
+	EXPECT_EQ(p.slotOf("y"), 3u);
+	EXPECT_DOUBLE_EQ(p.evaluate({ 0.5, 10, 4 }), 0.5 * 10.5 - 0.4);
+	EXPECT_THROW(p.evaluate({ 0.5, 10 }), std::invalid_argument);
+}
+
+TEST(ExpressionProgram, programs_of_a_translator_share_interned_names)
+{
+	ArithmeticTranslator translator;
+	ExpressionProgram a = translator.ToProgram("price * qty");
+	ExpressionProgram b = translator.ToProgram("qty - discount + price");
+
+	EXPECT_EQ(a.names(), b.names());
+	EXPECT_EQ(translator.interner()->size(), 3u);
+	EXPECT_EQ(a.variableIds()[0], b.variableIds()[2]);
+	EXPECT_EQ(a.variableIds()[1], b.variableIds()[0]);
+	// the same bytes, not equal copies
+	EXPECT_EQ(a.variable(0).data(), b.variable(2).data());
+	EXPECT_EQ(b.slotOf("discount"), 1u);
+	EXPECT_EQ(a.slotOf("discount"), 2u);
+
+	// another translator can name its variables in the same interner
+	ArithmeticTranslator other;
+	other.setInterner(translator.interner());
+	ExpressionProgram c = other.ToProgram("qty * 2");
+	EXPECT_EQ(c.variableIds()[0], a.variableIds()[1]);
+	EXPECT_EQ(translator.interner()->size(), 3u);
+}
+
+TEST(ExpressionProgram, tracks_the_stack_depth)
+{
+	ArithmeticTranslator translator;
+	EXPECT_EQ(translator.ToProgram("1 + 2 + 3 + 4").maxStack(), 2u);
+	EXPECT_EQ(translator.ToProgram("1 + (2 + (3 + 4))").maxStack(), 4u);
+
+	// deeper than the local stack of runProgram
+	std::string deep = "0";
+	for (int i = 1; i <= 100; ++i)
+		deep = std::to_string(i) + " + (" + deep + ")";
+	ExpressionProgram p = translator.ToProgram(deep);
+	EXPECT_EQ(p.maxStack(), 101u);
+	EXPECT_EQ(p.evaluate(std::vector<double>()), 5050);
+}
+
+TEST(ExpressionProgram, rejects_invalid_input)
+{
+	ArithmeticTranslator translator;
+	EXPECT_THROW(translator.ToProgram("1 +"), std::invalid_argument);
+	EXPECT_THROW(translator.ToProgram("(1 + 2"), std::invalid_argument);
+	EXPECT_THROW(translator.ToProgram("1 + 2)"), std::invalid_argument);
+	EXPECT_THROW(translator.ToProgram("x y"), std::invalid_argument);
+	EXPECT_THROW(translator.ToProgram("2 $ 3"), std::invalid_argument);
+	EXPECT_THROW(translator.ToProgram(""), std::invalid_argument);
+	EXPECT_THROW(translator.ToProgram("1 / 0").evaluate(std::vector<double>()), std::invalid_argument);
+}
+
+TEST(ExpressionProgram, bundle_round_trip)
+{
+	ArithmeticTranslator translator;
+	std::vector<ExpressionProgram> programs;
+	for (int i = 0; i < 500; ++i)
+		programs.push_back(translator.ToProgram("x * " + std::to_string(i) + " + y" + std::to_string(i % 7) + " ^ 2 - x"));
+	programs.push_back(translator.ToProgram("42"));
+	std::string path = tempPath("round_trip");
+	saveProgramBundle(path, programs);
+
+	{
+		MappedProgramBundle bundle(path);
+		ASSERT_EQ(bundle.size(), programs.size());
+		EXPECT_TRUE(bundle.verify());
+		// x and y0 .. y6, stored once for the whole bundle
+		EXPECT_EQ(bundle.nameCount(), 8u);
+		for (size_t i = 0; i < programs.size(); ++i) {
+			ProgramView v = bundle.program(i);
+			ASSERT_EQ(v.variableCount(), programs[i].variableCount());
+			for (size_t s = 0; s < v.variableCount(); ++s)
+				EXPECT_EQ(v.variable(s), programs[i].variable(s));
+			EXPECT_EQ(v.codeLength(), programs[i].code().size());
+			EXPECT_EQ(v.maxStack(), programs[i].maxStack());
+			std::vector<double> values = { 1.5, -2.0 };
+			EXPECT_EQ(v.evaluate(values), programs[i].evaluate(values));
+		}
+		EXPECT_EQ(bundle.program(500).evaluate(std::vector<double>()), 42);
+		EXPECT_EQ(bundle.program(3).slotOf("y3"), 1u);
+		EXPECT_THROW(bundle.program(programs.size()), std::out_of_range);
+	}
+	std::remove(path.c_str());
+}
+
+TEST(ExpressionProgram, empty_bundle_round_trip)
+{
+	std::string path = tempPath("empty");
+	saveProgramBundle(path, std::vector<ExpressionProgram>());
+	{
+		MappedProgramBundle bundle(path);
+		EXPECT_TRUE(bundle.empty());
+		EXPECT_TRUE(bundle.verify());
+	}
+	std::remove(path.c_str());
+}
+
+TEST(ExpressionProgram, bundle_open_checks_the_file)
+{
+	ArithmeticTranslator translator;
+	std::string path = tempPath("damaged");
+	saveProgramBundle(path, { translator.ToProgram("a + b * 2"), translator.ToProgram("a - 1") });
+	{
+		std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+		f.seekp(std::streamoff(sizeof(ProgramFileHeader) + 70));
+		f.put(0x55);
+	}
+	{
+		MappedProgramBundle bundle(path);
+		EXPECT_FALSE(bundle.verify());
+	}
+	{
+		std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+		f.seekp(offsetof(ProgramFileHeader, version));
+		f.put(9);
+	}
+	EXPECT_THROW(MappedProgramBundle bundle(path), std::runtime_error);
+	{
+		std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a bundle";
+	}
+	EXPECT_THROW(MappedProgramBundle bundle(path), std::runtime_error);
+	std::remove(path.c_str());
+	EXPECT_THROW(MappedProgramBundle bundle(path), std::runtime_error);
+}
+
+TEST(ExpressionProgram, incomplete_program_is_not_run_or_saved)
+{
+	ExpressionProgram empty;
+	EXPECT_THROW(empty.evaluate(std::vector<double>()), std::invalid_argument);
+
+	ExpressionProgram twoValues;
+	twoValues.pushConstant(1);
+	twoValues.pushConstant(2);
+	EXPECT_THROW(twoValues.evaluate(std::vector<double>()), std::invalid_argument);
+	EXPECT_THROW(saveProgramBundle(tempPath("incomplete"), { twoValues }), std::invalid_argument);
+}
+
+// Saves "a * 2 + b" and overwrites one field of the file
+template <class T>
+static void saveAndPatch(const std::string& path, size_t offset, T value) {
+	ArithmeticTranslator translator;
+	saveProgramBundle(path, { translator.ToProgram("a * 2 + b") });
+	std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+	f.seekp(std::streamoff(offset));
+	f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+TEST(ExpressionProgram, bundle_program_checks_code_against_its_tables)
+{
+	// code: VAR 0, CONST 0, MUL, VAR 1, ADD; one record before it
+	ProgramFileHeader header = {};
+	header.programCount = 1;
+	header.codeCount = 5;
+	header.constantCount = 1;
+	header.slotCount = 2;
+	header.nameCount = 2;
+	program_file::Layout layout(header);
+	size_t payload = sizeof(ProgramFileHeader);
+	size_t record = payload;
+	size_t code = payload + layout.code;
+	std::string path = tempPath("checks");
+
+	{
+		saveAndPatch(path, code + 4 * 3, uint32_t(OP_VAR | 1u << 8));
+		MappedProgramBundle intact(path);
+		EXPECT_EQ(intact.program(0).evaluate({ 3, 4 }), 10);
+	}
+	struct Patch {
+		const char* what;
+		size_t offset;
+		uint32_t value;
+	} patches[] = {
+		{ "constant index past the pool", code + 4 * 1, OP_CONST | 1u << 8 },
+		{ "slot index past the slots", code + 4 * 3, OP_VAR | 2u << 8 },
+		{ "unknown opcode", code + 4 * 2, 0x20 },
+		{ "operator without operands", code, OP_ADD },
+		{ "two values left", code + 4 * 4, OP_NEG },
+		{ "stack deeper than maxStack", record + offsetof(ProgramFileRecord, maxStack), 1 },
+		{ "huge maxStack", record + offsetof(ProgramFileRecord, maxStack), 0x7FFFFFFF },
+		{ "name index past the names", payload + layout.slots + 4, 2 },
+	};
+	for (const Patch& p : patches) {
+		saveAndPatch(path, p.offset, p.value);
+		MappedProgramBundle bundle(path);
+		EXPECT_THROW(bundle.program(0), std::runtime_error) << p.what;
+	}
+	std::remove(path.c_str());
+}
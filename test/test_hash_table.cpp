@@ -0,0 +1,260 @@
+#include "hash_table.h"
+#include <gtest.h>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+// Every key lands in the same group with the same tag
+struct CollidingHash {
+	size_t operator()(int) const { return 5; }
+};
+
+// Keys equal modulo a divisor that default-constructs as no divisor at all
+struct ModuloHash {
+	int divisor = 0;
+	size_t operator()(int k) const { return TableHash<int>()(divisor ? k % divisor : k); }
+};
+
+struct ModuloEqual {
+	int divisor = 0;
+	bool operator()(int a, int b) const { return divisor ? a % divisor == b % divisor : a == b; }
+};
+
+// Slots too large for any allocation to succeed
+struct Huge {
+	char bytes[size_t(1) << 30];
+};
+
+TEST(HashTable, empty_table_finds_nothing)
+{
+	HashTable<int, int> t;
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(t.capacity(), 0u);
+	EXPECT_EQ(t.find(1), nullptr);
+	EXPECT_FALSE(t.erase(1));
+}
+
+TEST(HashTable, grows_and_keeps_entries)
+{
+	HashTable<int, int> t;
+	for (int i = 0; i < 100000; ++i)
+		ASSERT_TRUE(t.insert(i, 2 * i));
+
+	EXPECT_FALSE(t.insert(42, 0));
+	EXPECT_EQ(t.size(), 100000u);
+	EXPECT_LE(t.loadFactor(), 0.875);
+	for (int i = 0; i < 100000; ++i)
+		ASSERT_EQ(*t.find(i), 2 * i);
+	EXPECT_EQ(t.find(100000), nullptr);
+}
+
+TEST(HashTable, matches_unordered_map_under_churn)
+{
+	HashTable<int, std::string> t;
+	std::unordered_map<int, std::string> ref;
+	for (int i = 0; i < 50000; ++i) {
+		int k = int((i * 2654435761u) % 3001);
+		if (i % 2) {
+			ASSERT_EQ(t.erase(k), ref.erase(k) == 1);
+		}
+		else {
+			ASSERT_EQ(t.insert(k, std::to_string(i)), ref.insert(std::make_pair(k, std::to_string(i))).second);
+		}
+	}
+
+	ASSERT_EQ(t.size(), ref.size());
+	size_t visited = 0;
+	t.for_each([&](const int& k, std::string& v) {
+		EXPECT_EQ(ref.at(k), v);
+		++visited;
+	});
+	EXPECT_EQ(visited, ref.size());
+}
+
+TEST(HashTable, full_collisions_probe_across_groups)
+{
+	HashTable<int, int, CollidingHash> t;
+	for (int i = 0; i < 200; ++i)
+		t.insert(i, i);
+	for (int i = 0; i < 200; i += 2)
+		t.erase(i);
+
+	for (int i = 0; i < 200; ++i) {
+		if (i % 2) {
+			ASSERT_EQ(*t.find(i), i);
+		}
+		else {
+			ASSERT_EQ(t.find(i), nullptr);
+		}
+	}
+}
+
+TEST(HashTable, tombstones_do_not_grow_table)
+{
+	HashTable<int, int> t;
+	t.reserve(1000);
+	size_t cap = t.capacity();
+	for (int round = 0; round < 100; ++round) {
+		for (int i = 0; i < 1000; ++i)
+			t.insert(round * 1000 + i, i);
+		for (int i = 0; i < 1000; ++i)
+			t.erase(round * 1000 + i);
+	}
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(t.capacity(), cap);
+}
+
+TEST(HashTable, string_view_lookup_without_string)
+{
+	HashTable<std::string, int> t;
+	t.insert("alpha", 1);
+	t.insert("beta", 2);
+
+	std::string_view text = "alpha beta gamma";
+	EXPECT_EQ(*t.find(text.substr(0, 5)), 1);
+	EXPECT_EQ(*t.find(text.substr(6, 4)), 2);
+	EXPECT_EQ(t.find(text.substr(11)), nullptr);
+	EXPECT_TRUE(t.erase(text.substr(0, 5)));
+	EXPECT_EQ(t.find("alpha"), nullptr);
+}
+
+TEST(HashTable, copy_and_move)
+{
+	HashTable<std::string, int> a;
+	for (int i = 0; i < 100; ++i)
+		a.insert(std::to_string(i), i);
+
+	HashTable<std::string, int> b(a);
+	b.erase("5");
+	EXPECT_EQ(*a.find("5"), 5);
+	EXPECT_EQ(b.size(), 99u);
+
+	HashTable<std::string, int> c(std::move(b));
+	EXPECT_EQ(c.size(), 99u);
+	EXPECT_TRUE(b.empty());
+	b = c;
+	EXPECT_EQ(*b.find("99"), 99);
+}
+
+TEST(HashTable, copy_keeps_hash_and_equality)
+{
+	typedef HashTable<int, int, ModuloHash, ModuloEqual> Table;
+	Table a(Table::RESIZE_AT_ONCE, ModuloHash{ 10 }, ModuloEqual{ 10 });
+	for (int i = 0; i < 10; ++i)
+		a.insert(i, i);
+	EXPECT_FALSE(a.insert(13, 0));
+
+	Table b(a);
+	EXPECT_FALSE(b.insert(13, 0));
+	ASSERT_NE(b.find(27), nullptr);
+	EXPECT_EQ(*b.find(27), 7);
+	Table c;
+	c = b;
+	ASSERT_NE(c.find(35), nullptr);
+	EXPECT_EQ(*c.find(35), 5);
+}
+
+TEST(HashTable, failed_rehash_leaves_table_intact)
+{
+	HashTable<int, int> t;
+	for (int i = 0; i < 100; ++i)
+		t.insert(i, i);
+	size_t cap = t.capacity();
+	// the control bytes can't be allocated
+	EXPECT_THROW(t.reserve(size_t(1) << 62), std::bad_alloc);
+	EXPECT_EQ(t.capacity(), cap);
+	EXPECT_EQ(t.size(), 100u);
+	for (int i = 0; i < 100; ++i)
+		ASSERT_EQ(*t.find(i), i);
+	t.insert(100, 100);
+	EXPECT_EQ(*t.find(100), 100);
+
+	// the control bytes are, the slots can't be
+	HashTable<int, Huge> h;
+	EXPECT_THROW(h.reserve(size_t(1) << 19), std::bad_alloc);
+	EXPECT_EQ(h.capacity(), 0u);
+	EXPECT_EQ(h.find(1), nullptr);
+}
+
+TEST(HashTable, incremental_resize_keeps_entries_visible)
+{
+	typedef HashTable<int, int> Table;
+	Table t(Table::RESIZE_INCREMENTAL);
+	bool sawMigration = false;
+	for (int i = 0; i < 50000; ++i) {
+		ASSERT_TRUE(t.insert(i, 2 * i));
+		if (t.isMigrating()) {
+			sawMigration = true;
+			// entries still in the old arrays and ones already moved
+			ASSERT_EQ(*t.find(0), 0);
+			ASSERT_EQ(*t.find(i), 2 * i);
+			ASSERT_EQ(*t.find(i / 2), 2 * (i / 2));
+			ASSERT_FALSE(t.insert(i / 3, 0));
+		}
+	}
+
+	EXPECT_TRUE(sawMigration);
+	EXPECT_EQ(t.size(), 50000u);
+	for (int i = 0; i < 50000; ++i)
+		ASSERT_EQ(*t.find(i), 2 * i);
+}
+
+TEST(HashTable, incremental_resize_erase_during_migration)
+{
+	typedef HashTable<int, int> Table;
+	Table t(Table::RESIZE_INCREMENTAL);
+	int i = 0;
+	while (!t.isMigrating())
+		t.insert(i++, i);
+	int n = i;
+	// erases also drive the migration, from both arrays
+	for (int k = 0; k < n; k += 2)
+		ASSERT_TRUE(t.erase(k));
+	EXPECT_FALSE(t.isMigrating());
+	EXPECT_EQ(t.size(), size_t(n / 2));
+
+	size_t visited = 0;
+	t.for_each([&](const int& k, int&) {
+		EXPECT_EQ(k % 2, 1);
+		++visited;
+	});
+	EXPECT_EQ(visited, t.size());
+	for (int k = 0; k < n; ++k)
+		ASSERT_EQ(t.find(k) != nullptr, k % 2 == 1);
+}
+
+TEST(HashTable, incremental_resize_copy_clear_and_reserve)
+{
+	typedef HashTable<std::string, int> Table;
+	Table t(Table::RESIZE_INCREMENTAL);
+	int n = 0;
+	while (!t.isMigrating()) {
+		t.insert(std::to_string(n), n);
+		++n;
+	}
+
+	Table copy(t);
+	EXPECT_EQ(copy.resizeMode(), Table::RESIZE_INCREMENTAL);
+	EXPECT_EQ(copy.size(), size_t(n));
+	EXPECT_EQ(*copy.find("0"), 0);
+
+	size_t sum = 0;
+	t.for_each([&](const std::string&, const int& v) { sum += size_t(v); });
+	EXPECT_EQ(sum, size_t(n) * size_t(n - 1) / 2);
+
+	// reserve finishes a running migration before it rehashes
+	t.reserve(10000);
+	EXPECT_FALSE(t.isMigrating());
+	EXPECT_EQ(*t.find(std::to_string(n - 1)), n - 1);
+
+	while (!copy.isMigrating())
+		copy.insert(std::to_string(n++), 0);
+	copy.clear();
+	EXPECT_TRUE(copy.empty());
+	EXPECT_FALSE(copy.isMigrating());
+	EXPECT_EQ(copy.find("0"), nullptr);
+}
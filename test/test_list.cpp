@@ -0,0 +1,213 @@
+#include "List.h"
+#include <gtest.h>
+
+
+TEST(List, can_create_list_with_size)
+{
+	List<int> l(5, 7);
+
+	EXPECT_EQ(l.size(), 5);
+	EXPECT_EQ(l[4], 7);
+}
+
+TEST(List, can_insert_after_node)
+{
+	List<int> l;
+	l.insert_front(3);
+	l.insert_front(1);
+	l.insert(2, l.get_first());
+
+	EXPECT_EQ(l.size(), 3);
+	EXPECT_EQ(l[0], 1);
+	EXPECT_EQ(l[1], 2);
+	EXPECT_EQ(l[2], 3);
+}
+
+TEST(List, can_erase_after_node)
+{
+	List<int> l(3, 1);
+	l[1] = 2;
+	l.erase(l.get_first());
+
+	EXPECT_EQ(l.size(), 2);
+	EXPECT_EQ(l[1], 1);
+}
+
+TEST(List, cant_erase_after_last_node)
+{
+	List<int> l(1);
+
+	ASSERT_ANY_THROW(l.erase(l.get_first()));
+}
+
+TEST(List, pool_reuses_erased_nodes)
+{
+	List<int> l;
+	l.insert_front(1);
+	List<int>::Node* node = l.get_first();
+	l.erase_front();
+
+	l.insert_front(2);
+
+	EXPECT_EQ(l.get_first(), node);
+}
+
+TEST(List, works_with_std_allocator)
+{
+	List<int, std::allocator<int>> l(3, 4);
+	l.insert_front(5);
+
+	EXPECT_EQ(l.size(), 4);
+	EXPECT_NE(l.find(5), nullptr);
+	EXPECT_EQ(l.find(6), nullptr);
+}
+
+TEST(List, can_copy_empty_list)
+{
+	List<int> l;
+
+	ASSERT_NO_THROW(List<int> copy(l));
+}
+
+TEST(List, copy_has_same_elements)
+{
+	List<int> l;
+	l.insert_front(3);
+	l.insert_front(2);
+	l.insert_front(1);
+
+	List<int> copy(l);
+
+	EXPECT_EQ(copy, l);
+	EXPECT_EQ(copy[0], 1);
+	EXPECT_EQ(copy[2], 3);
+}
+
+TEST(List, not_equal_lists_with_common_prefix)
+{
+	List<int> a(2, 1);
+	List<int> b(2, 1);
+	b[1] = 2;
+
+	EXPECT_TRUE(a != b);
+	EXPECT_FALSE(a == b);
+}
+
+TEST(List, move_takes_nodes_without_copy)
+{
+	List<int> l(3, 5);
+	List<int>::Node* node = l.get_first();
+
+	List<int> moved(std::move(l));
+
+	EXPECT_EQ(moved.get_first(), node);
+	EXPECT_TRUE(l.empty());
+}
+
+TEST(List, move_assignment_releases_old_nodes)
+{
+	List<int> a(3, 1);
+	List<int> b(2, 2);
+
+	a = std::move(b);
+
+	EXPECT_EQ(a.size(), 2);
+	EXPECT_EQ(a[0], 2);
+	EXPECT_TRUE(b.empty());
+}
+
+TEST(List, can_swap_lists)
+{
+	List<int> a(3, 1);
+	List<int> b(1, 2);
+
+	swap(a, b);
+
+	EXPECT_EQ(a.size(), 1);
+	EXPECT_EQ(b.size(), 3);
+}
+
+TEST(List, splice_moves_all_nodes_after_position)
+{
+	List<int> a;
+	a.insert_back(1);
+	a.insert_back(4);
+	List<int> b;
+	b.insert_back(2);
+	b.insert_back(3);
+
+	a.splice(a.get_first(), b);
+	a.insert_back(5);
+
+	EXPECT_TRUE(b.empty());
+	ASSERT_EQ(a.size(), 5);
+	for (int i = 0; i < 5; ++i)
+		EXPECT_EQ(a[i], i + 1);
+}
+
+TEST(List, splice_to_end_updates_last)
+{
+	List<int> a(1, 1);
+	List<int> b(1, 2);
+
+	a.splice(a.get_last(), b);
+
+	EXPECT_EQ(a.get_last()->data, 2);
+}
+
+TEST(List, can_sort)
+{
+	List<int> l;
+	int values[] = { 5, 3, 9, 1, 4, 1, 8, 2, 7 };
+	for (int v : values)
+		l.insert_back(v);
+
+	l.sort();
+
+	ASSERT_EQ(l.size(), 9);
+	for (int i = 1; i < 9; ++i)
+		EXPECT_LE(l[i - 1], l[i]);
+	EXPECT_EQ(l.get_last()->data, 9);
+}
+
+TEST(List, can_sort_with_comparator)
+{
+	List<int> l;
+	for (int i = 0; i < 100; ++i)
+		l.insert_back((i * 37) % 100);
+
+	l.sort(std::greater<int>());
+
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(l[i], 99 - i);
+}
+
+TEST(List, can_merge_sorted_lists)
+{
+	List<int> a;
+	List<int> b;
+	for (int i = 0; i < 10; i += 2)
+		a.insert_back(i);
+	for (int i = 1; i < 10; i += 2)
+		b.insert_back(i);
+
+	a.merge(b);
+	a.insert_back(10);
+
+	EXPECT_TRUE(b.empty());
+	ASSERT_EQ(a.size(), 11);
+	for (int i = 0; i < 11; ++i)
+		EXPECT_EQ(a[i], i);
+}
+
+TEST(List, print_reverse_keeps_list)
+{
+	List<int> l;
+	l.insert_back(1);
+	l.insert_back(2);
+
+	l.printReverse();
+
+	EXPECT_EQ(l[0], 1);
+	EXPECT_EQ(l.size(), 2);
+}
@@ -0,0 +1,65 @@
+#include "modint.h"
+#include "polynomial.h"
+#include <gtest.h>
+
+
+typedef MontgomeryInt<1000000007> Mod7;
+typedef BasicPolynomial<ModP61> PolyP;
+
+TEST(MontgomeryInt, round_trips_values)
+{
+	EXPECT_EQ(Mod7(0).value(), 0u);
+	EXPECT_EQ(Mod7(123456789).value(), 123456789u);
+	EXPECT_EQ(Mod7(1000000007).value(), 0u);
+	EXPECT_EQ(Mod7(-1).value(), 1000000006u);
+	EXPECT_EQ(ModP61(ModP61::MODULUS + 5).value(), 5u);
+}
+
+TEST(MontgomeryInt, arithmetic_matches_plain_modular_arithmetic)
+{
+	const uint64_t p = ModP61::MODULUS;
+	uint64_t a = 0x1234567890ABCDEFull % p, b = 0x0FEDCBA987654321ull % p;
+
+	EXPECT_EQ((ModP61(a) * ModP61(b)).value(), uint64_t((unsigned __int128)a * b % p));
+	EXPECT_EQ((ModP61(a) + ModP61(b)).value(), (a + b) % p);
+	EXPECT_EQ((ModP61(b) - ModP61(a)).value(), (b + p - a) % p);
+	EXPECT_EQ((-ModP61(a)).value(), p - a);
+}
+
+TEST(MontgomeryInt, inverse_and_division)
+{
+	Mod7 a(987654321);
+
+	EXPECT_EQ(a * a.inverse(), Mod7(1));
+	EXPECT_EQ((Mod7(6) / Mod7(3)).value(), 2u);
+	EXPECT_ANY_THROW(Mod7(0).inverse());
+}
+
+TEST(MontgomeryInt, fermat_little_theorem)
+{
+	EXPECT_EQ(ModP61(3).pow(ModP61::MODULUS - 1), ModP61(1));
+}
+
+TEST(MontgomeryInt, polynomial_over_residues_wraps_around)
+{
+	PolyP x = PolyP::monomial(1, 1, 0, 0);
+	PolyP p = x * ModP61(ModP61::MODULUS - 1) + PolyP(1);
+
+	// (1 - x) + x == 1 in Z/pZ
+	EXPECT_EQ(p + x, PolyP(1));
+	EXPECT_EQ(p.evaluate(2).value(), ModP61::MODULUS - 1);
+}
+
+TEST(MontgomeryInt, polynomial_product_strategies_agree)
+{
+	PolyP a, b;
+	for (unsigned i = 0; i < 40; ++i) {
+		a.addTerm(ModP61(uint64_t(i) * 0x9E3779B97F4A7C15ull), i, i % 3, 0);
+		b.addTerm(ModP61(uint64_t(i + 7) * 0xC2B2AE3D27D4EB4Full), i % 5, i, 1);
+	}
+
+	PolyP ref = PolyP::multiply(a, b, PolyP::MUL_SCHOOLBOOK);
+	EXPECT_EQ(PolyP::multiply(a, b, PolyP::MUL_HEAP), ref);
+	EXPECT_EQ(PolyP::multiply(a, b, PolyP::MUL_HASH), ref);
+	EXPECT_EQ(ref.evaluate(5, 7, 11), a.evaluate(5, 7, 11) * b.evaluate(5, 7, 11));
+}
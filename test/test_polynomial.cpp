@@ -0,0 +1,245 @@
+#include "polynomial.h"
+#include <gtest.h>
+#include <sstream>
+
+
+TEST(Polynomial, monomial_key_orders_by_x_then_y_then_z)
+{
+	EXPECT_GT(Monomial::pack(1, 0, 0), Monomial::pack(0, 5, 5));
+	EXPECT_GT(Monomial::pack(0, 1, 0), Monomial::pack(0, 0, 9));
+}
+
+TEST(Polynomial, monomial_keys_multiply_by_addition)
+{
+	Monomial::Key k = Monomial::mulKeys(Monomial::pack(1, 2, 3), Monomial::pack(4, 5, 6));
+
+	EXPECT_EQ(k, Monomial::pack(5, 7, 9));
+}
+
+TEST(Polynomial, throws_on_exponent_overflow)
+{
+	Monomial::Key big = Monomial::pack(0, Monomial::MAX_EXP, 0);
+
+	ASSERT_ANY_THROW(Monomial::mulKeys(big, Monomial::pack(0, 1, 0)));
+	ASSERT_ANY_THROW(Monomial::pack(Monomial::MAX_EXP + 1, 0, 0));
+}
+
+TEST(Polynomial, constructor_collects_like_terms)
+{
+	std::vector<Monomial> terms;
+	terms.push_back(Monomial(2, 1, 0, 0));
+	terms.push_back(Monomial(3, 0, 0, 0));
+	terms.push_back(Monomial(-2, 1, 0, 0));
+	terms.push_back(Monomial(1, 0, 0, 0));
+	Polynomial p(terms);
+
+	EXPECT_EQ(p.size(), 1);
+	EXPECT_EQ(p.coefficient(0, 0, 0), 4);
+}
+
+TEST(Polynomial, can_add_term)
+{
+	Polynomial p;
+	p.addTerm(1, 0, 1, 0);
+	p.addTerm(2, 2, 0, 0);
+	p.addTerm(-1, 0, 1, 0);
+
+	EXPECT_EQ(p.size(), 1);
+	EXPECT_EQ(p.coefficient(2, 0, 0), 2);
+}
+
+TEST(Polynomial, can_add_and_subtract)
+{
+	Polynomial p = Polynomial::monomial(1, 1, 0, 0) + Polynomial::monomial(2, 0, 1, 0);
+	Polynomial q = Polynomial::monomial(3, 1, 0, 0) - Polynomial::monomial(2, 0, 1, 0);
+
+	Polynomial sum = p + q;
+	Polynomial diff = p - p;
+
+	EXPECT_EQ(sum, Polynomial::monomial(4, 1, 0, 0));
+	EXPECT_TRUE(diff.isZero());
+}
+
+TEST(Polynomial, can_multiply)
+{
+	Polynomial x = Polynomial::monomial(1, 1, 0, 0);
+	Polynomial y = Polynomial::monomial(1, 0, 1, 0);
+
+	Polynomial p = (x + y) * (x - y);
+
+	EXPECT_EQ(p, x * x - y * y);
+	EXPECT_EQ(p.degree(), 2);
+}
+
+TEST(Polynomial, can_multiply_and_divide_by_scalar)
+{
+	Polynomial p = Polynomial::monomial(3, 1, 1, 1) + 6;
+
+	EXPECT_EQ(p * 2, 2 * p);
+	EXPECT_EQ((p / 3).coefficient(0, 0, 0), 2);
+	EXPECT_TRUE((p * 0).isZero());
+	ASSERT_ANY_THROW(p / 0);
+}
+
+TEST(Polynomial, can_evaluate)
+{
+	// 2*x^2*y - z + 1
+	Polynomial p = Polynomial::monomial(2, 2, 1, 0) - Polynomial::monomial(1, 0, 0, 1) + 1;
+
+	EXPECT_EQ(p.evaluate(3, 2, 5), 32);
+}
+
+TEST(Polynomial, can_print)
+{
+	Polynomial p = Polynomial::monomial(3, 2, 1, 0) - Polynomial::monomial(1, 0, 0, 1) + 1;
+	std::ostringstream out;
+	out << p;
+
+	EXPECT_EQ(out.str(), "3*x^2*y - z + 1");
+}
+
+TEST(Polynomial, all_multiplication_methods_agree)
+{
+	std::vector<Monomial> ta, tb;
+	for (unsigned i = 0; i < 40; ++i) {
+		ta.push_back(Monomial(double(i % 7) - 3, i % 5, (i * 3) % 4, i % 3));
+		tb.push_back(Monomial(double(i % 5) + 1, (i * 7) % 6, i % 2, (i * 5) % 7));
+	}
+	Polynomial a(ta), b(tb);
+
+	Polynomial expected = Polynomial::multiply(a, b, Polynomial::MUL_SCHOOLBOOK);
+
+	EXPECT_EQ(expected, Polynomial::multiply(a, b, Polynomial::MUL_HEAP));
+	EXPECT_EQ(expected, Polynomial::multiply(a, b, Polynomial::MUL_HASH));
+	EXPECT_EQ(expected, a * b);
+}
+
+TEST(Polynomial, heap_multiplication_cancels_terms)
+{
+	Polynomial x = Polynomial::monomial(1, 1, 0, 0);
+	Polynomial y = Polynomial::monomial(1, 0, 1, 0);
+
+	Polynomial p = Polynomial::multiply(x + y, x - y, Polynomial::MUL_HEAP);
+
+	EXPECT_EQ(x * x - y * y, p);
+}
+
+TEST(Polynomial, multiplication_checks_overflow_up_front)
+{
+	Polynomial big = Polynomial::monomial(1, 0, 0, Monomial::MAX_EXP) + 1;
+	Polynomial z = Polynomial::monomial(1, 0, 0, 1) + 1;
+
+	ASSERT_ANY_THROW(Polynomial::multiply(big, z, Polynomial::MUL_HEAP));
+	ASSERT_ANY_THROW(Polynomial::multiply(big, z, Polynomial::MUL_HASH));
+}
+
+TEST(Polynomial, evaluates_at_many_points)
+{
+	// 2*x^3 - x + 5, dense path
+	Polynomial p = Polynomial::monomial(2, 3, 0, 0) - Polynomial::monomial(1, 1, 0, 0) + 5;
+	std::vector<double> xs, out(150);
+	for (int i = 0; i < 150; ++i)
+		xs.push_back(i * 0.01 - 0.7);
+
+	p.evaluate(xs, out);
+
+	for (int i = 0; i < 150; ++i)
+		EXPECT_NEAR(out[i], p.evaluate(xs[i]), 1e-12);
+}
+
+TEST(Polynomial, estrin_matches_horner)
+{
+	Polynomial p;
+	for (unsigned e = 0; e < 37; ++e)
+		p.addTerm(double(e % 5) - 2, e, 0, 0);
+	std::vector<double> xs, horner(100), estrin(100);
+	for (int i = 0; i < 100; ++i)
+		xs.push_back(i * 0.02 - 1);
+
+	p.evaluate(xs, horner, MultiPointEval::HORNER);
+	p.evaluate(xs, estrin, MultiPointEval::ESTRIN);
+
+	for (int i = 0; i < 100; ++i)
+		EXPECT_NEAR(horner[i], estrin[i], 1e-12);
+}
+
+TEST(Polynomial, evaluates_very_sparse_polynomial_at_many_points)
+{
+	Polynomial p = Polynomial::monomial(1, 500, 0, 0) + Polynomial::monomial(3, 2, 0, 0);
+	std::vector<double> xs = { 1.0, -1.0, 0.5, 1.001 }, out(4);
+
+	p.evaluate(xs, out);
+
+	for (int i = 0; i < 4; ++i)
+		EXPECT_NEAR(out[i] / p.evaluate(xs[i]), 1, 1e-12);
+}
+
+TEST(Polynomial, evaluates_multivariate_at_many_points)
+{
+	// 2*x^2*y - z^3 + x*y*z + 1
+	Polynomial p = Polynomial::monomial(2, 2, 1, 0) - Polynomial::monomial(1, 0, 0, 3)
+		+ Polynomial::monomial(1, 1, 1, 1) + 1;
+	std::vector<double> xs, ys, zs, out(70);
+	for (int i = 0; i < 70; ++i) {
+		xs.push_back(i * 0.1);
+		ys.push_back(1 - i * 0.05);
+		zs.push_back(i % 7 - 3.0);
+	}
+
+	p.evaluate(xs, ys, zs, out);
+
+	for (int i = 0; i < 70; ++i)
+		EXPECT_NEAR(out[i], p.evaluate(xs[i], ys[i], zs[i]), 1e-9);
+}
+
+TEST(Polynomial, multipoint_evaluation_checks_arguments)
+{
+	Polynomial p = Polynomial::monomial(1, 1, 1, 0);
+	std::vector<double> xs(3), out(3), shorter(2);
+
+	ASSERT_ANY_THROW(p.evaluate(xs, out));
+	ASSERT_ANY_THROW(p.evaluate(xs, std::span<const double>(), std::span<const double>(), out));
+	ASSERT_ANY_THROW(p.evaluate(xs, shorter, std::span<const double>(), out));
+}
+
+static std::vector<Polynomial> manyPolynomials(int count)
+{
+	std::vector<Polynomial> res;
+	for (int k = 0; k < count; ++k) {
+		Polynomial p;
+		for (unsigned t = 0; t < 5; ++t)
+			p.addTerm(double((k + t) % 9) - 4, (k + t) % 6, (k * t) % 4, t % 3);
+		res.push_back(p);
+	}
+	return res;
+}
+
+TEST(Polynomial, sum_matches_pairwise_addition)
+{
+	std::vector<Polynomial> polys = manyPolynomials(300);
+	Polynomial expected;
+	for (size_t i = 0; i < polys.size(); ++i)
+		expected += polys[i];
+
+	EXPECT_EQ(expected, Polynomial::sum(polys));
+	EXPECT_EQ(expected, Polynomial::sum(polys.begin(), polys.end()));
+}
+
+TEST(Polynomial, parallel_sum_matches_sequential_sum)
+{
+	std::vector<Polynomial> polys = manyPolynomials(301);
+
+	Polynomial sequential = Polynomial::sum(polys);
+
+	EXPECT_EQ(sequential, Polynomial::sum(polys, 4));
+	EXPECT_EQ(sequential, Polynomial::sum(polys, 3));
+}
+
+TEST(Polynomial, sum_cancels_terms)
+{
+	Polynomial x = Polynomial::monomial(1, 1, 0, 0);
+	std::vector<Polynomial> polys = { x + 1, -x, Polynomial(), Polynomial(-1) };
+
+	EXPECT_TRUE(Polynomial::sum(polys).isZero());
+	EXPECT_TRUE(Polynomial::sum(std::vector<Polynomial>()).isZero());
+}
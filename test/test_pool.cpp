@@ -0,0 +1,121 @@
+#include "pool.h"
+#include <gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Block types of their own, so each test sees pools no other test touched
+template <int Tag>
+struct Block {
+	long payload[4];
+};
+
+template <class T>
+using PoolOf = FixedPool<sizeof(T), alignof(T)>;
+
+template <class T>
+static std::vector<T*> allocateMany(size_t n) {
+	PoolAllocator<T> alloc;
+	std::vector<T*> blocks(n);
+	for (size_t i = 0; i < n; ++i)
+		blocks[i] = alloc.allocate(1);
+	return blocks;
+}
+
+template <class T>
+static void deallocateAll(const std::vector<T*>& blocks) {
+	PoolAllocator<T> alloc;
+	for (T* p : blocks)
+		alloc.deallocate(p, 1);
+}
+
+TEST(FixedPool, blocks_of_an_ended_thread_are_reused)
+{
+	typedef Block<1> B;
+	std::thread([] { deallocateAll(allocateMany<B>(100000)); }).join();
+	size_t reserved = PoolOf<B>::reservedBytes();
+	EXPECT_GE(PoolOf<B>::depotBlocks(), 100000u);
+
+	for (int round = 0; round < 5; ++round)
+		std::thread([] { deallocateAll(allocateMany<B>(100000)); }).join();
+
+	EXPECT_EQ(PoolOf<B>::reservedBytes(), reserved);
+}
+
+TEST(FixedPool, blocks_freed_on_another_thread_flow_back)
+{
+	typedef Block<2> B;
+	// the main thread makes every block, a consumer thread frees them
+	std::vector<B*> blocks = allocateMany<B>(50000);
+	size_t reserved = PoolOf<B>::reservedBytes();
+	for (int round = 0; round < 20; ++round) {
+		std::thread([&] { deallocateAll(blocks); }).join();
+		blocks = allocateMany<B>(50000);
+	}
+	deallocateAll(blocks);
+
+	// rounds reuse the blocks freed by the consumers instead of new chunks
+	EXPECT_LE(PoolOf<B>::reservedBytes(), 2 * reserved);
+}
+
+TEST(FixedPool, long_lived_consumer_hands_back_its_excess)
+{
+	typedef Block<3> B;
+	std::vector<B*> handoff;
+	std::vector<B*> produced;
+	size_t reserved = 0;
+	// one producer and one consumer thread that both live for every round
+	std::thread consumerThread;
+	std::mutex m;
+	std::condition_variable cv;
+	int ready = 0, done = 0;
+	bool stop = false;
+	consumerThread = std::thread([&] {
+		for (;;) {
+			std::unique_lock<std::mutex> lock(m);
+			cv.wait(lock, [&] { return ready > done || stop; });
+			if (ready == done && stop)
+				return;
+			std::vector<B*> batch;
+			batch.swap(handoff);
+			lock.unlock();
+			deallocateAll(batch);
+			lock.lock();
+			++done;
+			cv.notify_all();
+		}
+	});
+	for (int round = 0; round < 30; ++round) {
+		produced = allocateMany<B>(20000);
+		if (round == 0)
+			reserved = PoolOf<B>::reservedBytes();
+		std::unique_lock<std::mutex> lock(m);
+		handoff.swap(produced);
+		++ready;
+		cv.notify_all();
+		cv.wait(lock, [&] { return done == ready; });
+	}
+	{
+		std::lock_guard<std::mutex> lock(m);
+		stop = true;
+	}
+	cv.notify_all();
+	consumerThread.join();
+
+	// the consumer keeps at most MAX_FREE blocks, the rest go back to the
+	// producer through the depot
+	EXPECT_LE(PoolOf<B>::reservedBytes(), 2 * reserved);
+}
+
+TEST(FixedPool, same_thread_reuses_the_last_freed_block)
+{
+	typedef Block<4> B;
+	PoolAllocator<B> alloc;
+	B* p = alloc.allocate(1);
+	alloc.deallocate(p, 1);
+
+	EXPECT_EQ(alloc.allocate(1), p);
+	alloc.deallocate(p, 1);
+}
@@ -0,0 +1,133 @@
+#include "rb_table.h"
+#include <gtest.h>
+#include <map>
+#include <string>
+
+
+TEST(RBTable, empty_table_finds_nothing)
+{
+	RBTable<int, int> t;
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_TRUE(t.isValid());
+	EXPECT_EQ(t.find(0), nullptr);
+	EXPECT_FALSE(t.erase(0));
+}
+
+TEST(RBTable, sequential_inserts_keep_invariants)
+{
+	RBTable<int, int> t;
+	for (int i = 0; i < 5000; ++i)
+		ASSERT_TRUE(t.insert(i, -i));
+
+	EXPECT_FALSE(t.insert(7, 0));
+	EXPECT_EQ(t.size(), 5000u);
+	EXPECT_TRUE(t.isValid());
+	for (int i = 0; i < 5000; ++i)
+		ASSERT_EQ(*t.find(i), -i);
+}
+
+TEST(RBTable, matches_std_map_under_random_inserts_and_erases)
+{
+	RBTable<int, std::string> t;
+	std::map<int, std::string> ref;
+	for (int i = 0; i < 20000; ++i) {
+		int k = int((i * 2654435761u) % 2053);
+		if (i % 3 == 2) {
+			ASSERT_EQ(t.erase(k), ref.erase(k) == 1);
+		}
+		else {
+			ASSERT_EQ(t.insert(k, std::to_string(i)), ref.insert(std::make_pair(k, std::to_string(i))).second);
+		}
+		if (i % 1000 == 0) {
+			ASSERT_TRUE(t.isValid());
+		}
+	}
+
+	ASSERT_EQ(t.size(), ref.size());
+	EXPECT_TRUE(t.isValid());
+	std::map<int, std::string>::const_iterator it = ref.begin();
+	t.for_each([&](const int& k, std::string& v) {
+		ASSERT_TRUE(it != ref.end());
+		EXPECT_EQ(k, it->first);
+		EXPECT_EQ(v, it->second);
+		++it;
+	});
+	EXPECT_TRUE(it == ref.end());
+}
+
+TEST(RBTable, erase_everything_then_reuse_slots)
+{
+	RBTable<int, int> t;
+	for (int i = 0; i < 1000; ++i)
+		t.insert(i, i);
+	size_t bytes = t.memoryUsage();
+	for (int i = 0; i < 1000; ++i)
+		ASSERT_TRUE(t.erase((i * 7) % 1000));
+
+	EXPECT_TRUE(t.empty());
+	for (int i = 0; i < 1000; ++i)
+		t.insert(-i, i);
+
+	EXPECT_TRUE(t.isValid());
+	EXPECT_EQ(t.memoryUsage(), bytes);
+}
+
+TEST(RBTable, range_is_half_open)
+{
+	RBTable<int, int> t;
+	for (int i = 0; i < 100; ++i)
+		t.insert(i * 10, i);
+
+	std::vector<int> keys;
+	t.range(25, 70, [&](const int& k, const int&) { keys.push_back(k); });
+
+	std::vector<int> expected = { 30, 40, 50, 60 };
+	EXPECT_EQ(keys, expected);
+}
+
+TEST(RBTable, copy_is_independent)
+{
+	RBTable<int, int> a;
+	for (int i = 0; i < 50; ++i)
+		a.insert(i, i);
+	RBTable<int, int> b(a);
+
+	b.erase(10);
+	*b.find(20) = -1;
+
+	EXPECT_EQ(*a.find(10), 10);
+	EXPECT_EQ(*a.find(20), 20);
+	EXPECT_EQ(b.size(), 49u);
+	EXPECT_TRUE(b.isValid());
+}
+
+TEST(RBTable, select_and_rank_follow_inserts_and_erases)
+{
+	RBTable<int, int> t;
+	std::map<int, int> ref;
+	for (int i = 0; i < 5000; ++i) {
+		int k = int((i * 2654435761u) % 1021);
+		if (i % 3 == 2) {
+			t.erase(k);
+			ref.erase(k);
+		}
+		else {
+			t.insert(k, i);
+			ref.insert(std::make_pair(k, i));
+		}
+	}
+
+	ASSERT_TRUE(t.isValid());
+	size_t r = 0;
+	for (std::map<int, int>::const_iterator it = ref.begin(); it != ref.end(); ++it, ++r) {
+		const int* key = t.select(r);
+		ASSERT_NE(key, nullptr);
+		ASSERT_EQ(*key, it->first);
+		ASSERT_EQ(t.rank(it->first), r);
+		ASSERT_EQ(t.rank(it->first + 1), r + 1);
+	}
+	EXPECT_EQ(t.select(ref.size()), nullptr);
+	EXPECT_EQ(t.rank(-1), 0u);
+	EXPECT_EQ(t.rank(5000), t.size());
+}
@@ -0,0 +1,119 @@
+#include "sorted_table.h"
+#include <gtest.h>
+#include <map>
+#include <string>
+
+
+TEST(SortedTable, empty_table_finds_nothing)
+{
+	SortedTable<int, int> t;
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(t.find(1), nullptr);
+	EXPECT_FALSE(t.erase(1));
+}
+
+TEST(SortedTable, bulk_build_from_unsorted_input)
+{
+	std::vector<std::pair<int, std::string>> items;
+	for (int i = 0; i < 100; ++i)
+		items.push_back(std::make_pair((i * 37) % 100, std::to_string((i * 37) % 100)));
+	SortedTable<int, std::string> t(items);
+
+	ASSERT_EQ(t.size(), 100u);
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_NE(t.find(i), nullptr);
+		EXPECT_EQ(*t.find(i), std::to_string(i));
+	}
+	EXPECT_EQ(t.find(-1), nullptr);
+	EXPECT_EQ(t.find(100), nullptr);
+}
+
+TEST(SortedTable, last_duplicate_wins_in_bulk_build)
+{
+	std::vector<std::pair<int, int>> items = { { 1, 10 }, { 2, 20 }, { 1, 11 } };
+	SortedTable<int, int> t(items);
+
+	EXPECT_EQ(t.size(), 2u);
+	EXPECT_EQ(*t.find(1), 11);
+}
+
+TEST(SortedTable, for_each_visits_keys_in_order)
+{
+	for (int n = 0; n < 40; ++n) {
+		std::vector<std::pair<int, int>> items;
+		for (int i = n; i-- > 0;)
+			items.push_back(std::make_pair(2 * i, i));
+		SortedTable<int, int> t(items);
+
+		std::vector<int> seen;
+		t.for_each([&](const int& k, int& v) { seen.push_back(k); EXPECT_EQ(k, 2 * v); });
+		ASSERT_EQ(seen.size(), size_t(n));
+		for (int i = 0; i < n; ++i)
+			EXPECT_EQ(seen[i], 2 * i);
+	}
+}
+
+TEST(SortedTable, lookups_between_keys_miss_for_every_size)
+{
+	for (int n = 1; n < 70; ++n) {
+		std::vector<std::pair<int, int>> items;
+		for (int i = 0; i < n; ++i)
+			items.push_back(std::make_pair(2 * i, i));
+		SortedTable<int, int> t(items);
+
+		for (int q = -1; q <= 2 * n; ++q) {
+			const int* v = t.find(q);
+			if (q >= 0 && q < 2 * n && q % 2 == 0) {
+				ASSERT_NE(v, nullptr);
+				EXPECT_EQ(*v, q / 2);
+			}
+			else {
+				EXPECT_EQ(v, nullptr);
+			}
+		}
+	}
+}
+
+TEST(SortedTable, insert_and_erase_keep_table_searchable)
+{
+	SortedTable<int, int> t;
+	std::map<int, int> ref;
+	for (int i = 0; i < 200; ++i) {
+		int k = (i * 7919) % 101;
+		EXPECT_EQ(t.insert(k, i), ref.insert(std::make_pair(k, i)).second);
+		if (i % 3 == 0) {
+			int e = (i * 31) % 101;
+			EXPECT_EQ(t.erase(e), ref.erase(e) == 1);
+		}
+	}
+
+	ASSERT_EQ(t.size(), ref.size());
+	for (int k = 0; k < 101; ++k) {
+		std::map<int, int>::iterator it = ref.find(k);
+		if (it == ref.end()) {
+			EXPECT_EQ(t.find(k), nullptr);
+		}
+		else {
+			EXPECT_EQ(*t.find(k), it->second);
+		}
+	}
+}
+
+TEST(SortedTable, batch_lookup_matches_single_lookups)
+{
+	std::vector<std::pair<long, long>> items;
+	for (long i = 0; i < 1000; ++i)
+		items.push_back(std::make_pair(3 * i, i));
+	SortedTable<long, long> t(items);
+
+	std::vector<long> queries;
+	for (long q = -5; q < 3005; q += 2)
+		queries.push_back(q);
+	std::vector<long*> out(queries.size());
+	t.findBatch(queries, out);
+
+	for (size_t i = 0; i < queries.size(); ++i)
+		EXPECT_EQ(out[i], t.find(queries[i]));
+	EXPECT_ANY_THROW(t.findBatch(queries, std::span<long*>(out.data(), 1)));
+}
@@ -0,0 +1,67 @@
+#include "string_interner.h"
+#include <gtest.h>
+#include <string>
+#include <vector>
+
+
+TEST(StringInterner, same_text_gets_same_id)
+{
+	StringInterner names;
+	uint32_t x = names.intern("x");
+	uint32_t rate = names.intern("rate");
+
+	EXPECT_NE(x, rate);
+	EXPECT_EQ(names.intern("x"), x);
+	EXPECT_EQ(names.intern(std::string("ra") + "te"), rate);
+	EXPECT_EQ(names.size(), 2u);
+	EXPECT_EQ(names.textBytes(), 5u);
+	EXPECT_EQ(names.name(rate), "rate");
+}
+
+TEST(StringInterner, ids_are_dense_in_order_of_first_intern)
+{
+	StringInterner names;
+	EXPECT_TRUE(names.empty());
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(names.intern("v" + std::to_string(i)), uint32_t(i));
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(names.intern("v" + std::to_string(i)), uint32_t(i));
+	EXPECT_EQ(names.size(), 100u);
+}
+
+TEST(StringInterner, find_does_not_intern)
+{
+	StringInterner names;
+	names.intern("a");
+
+	EXPECT_EQ(names.find("a"), 0u);
+	EXPECT_EQ(names.find("b"), StringInterner::NONE);
+	EXPECT_EQ(names.size(), 1u);
+}
+
+TEST(StringInterner, empty_text_is_a_name)
+{
+	StringInterner names;
+	uint32_t id = names.intern("");
+
+	EXPECT_EQ(names.intern(""), id);
+	EXPECT_EQ(names.name(id), "");
+}
+
+TEST(StringInterner, names_stay_valid_as_the_arena_grows)
+{
+	StringInterner names;
+	std::vector<std::string_view> views;
+	// enough text for several chunks, and one text longer than a chunk
+	for (int i = 0; i < 20000; ++i)
+		views.push_back(names.name(names.intern("identifier_" + std::to_string(i))));
+	std::string longText(100000, 'q');
+	std::string_view longView = names.name(names.intern(longText));
+
+	for (int i = 0; i < 20000; ++i) {
+		ASSERT_EQ(views[i], "identifier_" + std::to_string(i));
+		ASSERT_EQ(views[i].data(), names.name(uint32_t(i)).data());
+	}
+	EXPECT_EQ(longView, longText);
+	EXPECT_EQ(names.find(longText), 20000u);
+}
@@ -0,0 +1,150 @@
+#include "table.h"
+#include <gtest.h>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+typedef Table<int, int> IntTable;
+
+static const IntTable::Backend ALL_BACKENDS[] = {
+	IntTable::BACKEND_UNSORTED, IntTable::BACKEND_SORTED, IntTable::BACKEND_AVL,
+	IntTable::BACKEND_RB, IntTable::BACKEND_HASH, IntTable::BACKEND_AUTO, IntTable::BACKEND_AUTO_ORDERED
+};
+
+TEST(Table, every_backend_matches_std_map)
+{
+	for (IntTable::Backend b : ALL_BACKENDS) {
+		IntTable t(b);
+		std::map<int, int> ref;
+		unsigned x = 1;
+		for (int i = 0; i < 3000; ++i) {
+			x = x * 1103515245u + 12345u;
+			int key = int((x >> 8) % 500);
+			if ((x >> 4) % 3 == 0) {
+				ASSERT_EQ(t.erase(key), ref.erase(key) == 1);
+			}
+			else {
+				ASSERT_EQ(t.insert(key, i), ref.insert(std::make_pair(key, i)).second);
+			}
+			int* v = t.find(key);
+			auto it = ref.find(key);
+			ASSERT_EQ(v != nullptr, it != ref.end());
+			if (v) {
+				ASSERT_EQ(*v, it->second);
+			}
+		}
+		EXPECT_EQ(t.size(), ref.size()) << "backend " << b;
+	}
+}
+
+TEST(Table, fixed_backend_never_migrates)
+{
+	IntTable t(IntTable::BACKEND_RB);
+	for (int i = 0; i < 10000; ++i)
+		t.insert(i, i);
+	for (int i = 0; i < 10000; ++i)
+		t.find(i);
+
+	EXPECT_EQ(t.backend(), IntTable::BACKEND_RB);
+	EXPECT_EQ(t.migrationCount(), 0u);
+}
+
+TEST(Table, auto_moves_growing_catalog_to_hash_table)
+{
+	Table<std::string, int> t;
+	for (int i = 0; i < 10; ++i)
+		t.insert("p" + std::to_string(i), i);
+	for (int r = 0; r < 10; ++r)
+		t.find("p3");
+	EXPECT_EQ(t.backend(), (Table<std::string, int>::BACKEND_UNSORTED));
+
+	for (int i = 10; i < 100000; ++i)
+		t.insert("p" + std::to_string(i), i);
+	EXPECT_EQ(t.backend(), (Table<std::string, int>::BACKEND_HASH));
+	EXPECT_EQ(t.size(), 100000u);
+	for (int i = 0; i < 100000; i += 97)
+		ASSERT_EQ(*t.find("p" + std::to_string(i)), i);
+}
+
+TEST(Table, auto_ordered_follows_read_write_mix)
+{
+	IntTable t(IntTable::BACKEND_AUTO_ORDERED);
+	for (int i = 0; i < 5000; ++i)
+		t.insert(i * 7 % 5000, i);
+	// insert-only growth leaves the sorted array for a tree
+	EXPECT_EQ(t.backend(), IntTable::BACKEND_RB);
+
+	for (int r = 0; r < 3; ++r)
+		for (int i = 0; i < 5000; ++i)
+			ASSERT_NE(t.find(i), nullptr);
+	EXPECT_EQ(t.backend(), IntTable::BACKEND_SORTED);
+
+	int prev = -1;
+	t.for_each([&](const int& k, const int&) {
+		EXPECT_LT(prev, k);
+		prev = k;
+	});
+	EXPECT_EQ(prev, 4999);
+}
+
+TEST(Table, set_backend_keeps_entries)
+{
+	IntTable t(IntTable::BACKEND_HASH);
+	for (int i = 0; i < 1000; ++i)
+		t.insert(i, -i);
+
+	for (IntTable::Backend b : ALL_BACKENDS) {
+		t.setBackend(b);
+		ASSERT_EQ(t.size(), 1000u);
+		for (int i = 0; i < 1000; ++i)
+			ASSERT_EQ(*t.find(i), -i);
+	}
+	// an auto ordered policy never leaves entries in an unordered backend
+	t.setBackend(IntTable::BACKEND_HASH);
+	t.setBackend(IntTable::BACKEND_AUTO_ORDERED);
+	EXPECT_EQ(t.backend(), IntTable::BACKEND_RB);
+}
+
+TEST(Table, clear_forgets_the_workload)
+{
+	IntTable t(IntTable::BACKEND_AUTO_ORDERED);
+	// write-only, so the entries move to the red-black tree
+	for (int i = 0; i < 200; ++i)
+		t.insert(i, i);
+	ASSERT_EQ(t.backend(), IntTable::BACKEND_RB);
+	const IntTable& view = t;
+	for (int i = 0; i < 100000; ++i)
+		view.find(i % 200);
+	size_t migrations = t.migrationCount();
+
+	// the reads before clear() must not move the new entries to the
+	// sorted array
+	t.clear();
+	t.insert(1, 1);
+
+	EXPECT_EQ(t.backend(), IntTable::BACKEND_RB);
+	EXPECT_EQ(t.migrationCount(), migrations);
+}
+
+TEST(Table, const_find_from_several_threads)
+{
+	IntTable t(IntTable::BACKEND_AUTO);
+	for (int i = 0; i < 1000; ++i)
+		t.insert(i, 2 * i);
+	const IntTable& view = t;
+
+	std::vector<std::thread> readers;
+	std::vector<long> sums(4, 0);
+	for (size_t r = 0; r < sums.size(); ++r)
+		readers.emplace_back([&view, &sums, r] {
+			for (int i = 0; i < 20000; ++i)
+				sums[r] += *view.find(i % 1000);
+		});
+	for (std::thread& reader : readers)
+		reader.join();
+
+	for (long sum : sums)
+		EXPECT_EQ(sum, 20L * 999 * 1000);
+}
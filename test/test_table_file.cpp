@@ -0,0 +1,208 @@
+#include "table_file.h"
+#include <gtest.h>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+
+// Path of a scratch file, removed when the test ends
+class TempPath {
+	std::string p;
+
+public:
+	explicit TempPath(const std::string& name) : p((std::filesystem::temp_directory_path() / ("table_file_" + name)).string()) {}
+	~TempPath() { std::remove(p.c_str()); }
+	const std::string& str() const { return p; }
+};
+
+static void patchByte(const std::string& path, size_t offset, char value) {
+	std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+	f.seekp(std::streamoff(offset));
+	f.put(value);
+}
+
+TEST(TableFile, sorted_table_round_trip)
+{
+	TempPath path("sorted");
+	SortedTable<int, double> t;
+	std::map<int, double> ref;
+	for (int i = 0; i < 1000; ++i) {
+		int k = (i * 7919) % 1009;
+		if (t.insert(k, k * 0.5))
+			ref[k] = k * 0.5;
+	}
+	saveTable(path.str(), t);
+
+	MappedSortedTable<int, double> m(path.str());
+	EXPECT_EQ(m.size(), ref.size());
+	EXPECT_TRUE(m.verify());
+	for (int k = -5; k < 1020; ++k) {
+		const double* v = m.find(k);
+		if (ref.count(k)) {
+			ASSERT_NE(v, nullptr);
+			EXPECT_EQ(*v, ref[k]);
+		}
+		else {
+			EXPECT_EQ(v, nullptr);
+		}
+	}
+	std::vector<int> keys;
+	m.for_each([&](int k, double v) {
+		EXPECT_EQ(v, k * 0.5);
+		keys.push_back(k);
+	});
+	std::vector<int> expected;
+	for (auto& e : ref)
+		expected.push_back(e.first);
+	EXPECT_EQ(keys, expected);
+}
+
+TEST(TableFile, hash_table_round_trip)
+{
+	TempPath path("hash");
+	HashTable<uint64_t, uint32_t> t;
+	for (uint64_t i = 0; i < 5000; ++i)
+		t.insert(i * 31, uint32_t(i));
+	// tombstones are not written
+	for (uint64_t i = 0; i < 5000; i += 3)
+		t.erase(i * 31);
+	saveTable(path.str(), t);
+
+	MappedHashTable<uint64_t, uint32_t> m(path.str());
+	EXPECT_EQ(m.size(), t.size());
+	EXPECT_TRUE(m.verify());
+	for (uint64_t i = 0; i < 5000; ++i) {
+		const uint32_t* v = m.find(i * 31);
+		if (i % 3 == 0) {
+			EXPECT_EQ(v, nullptr);
+		}
+		else {
+			ASSERT_NE(v, nullptr);
+			EXPECT_EQ(*v, uint32_t(i));
+		}
+		EXPECT_EQ(m.find(i * 31 + 1), nullptr);
+	}
+	size_t count = 0;
+	m.for_each([&](uint64_t k, uint32_t v) {
+		EXPECT_EQ(k, uint64_t(v) * 31);
+		++count;
+	});
+	EXPECT_EQ(count, t.size());
+}
+
+TEST(TableFile, empty_tables_round_trip)
+{
+	TempPath sortedPath("empty_sorted"), hashPath("empty_hash");
+	saveTable(sortedPath.str(), SortedTable<int, int>());
+	saveTable(hashPath.str(), HashTable<int, int>());
+
+	MappedSortedTable<int, int> s(sortedPath.str());
+	MappedHashTable<int, int> h(hashPath.str());
+	EXPECT_TRUE(s.empty());
+	EXPECT_TRUE(h.empty());
+	EXPECT_EQ(s.find(1), nullptr);
+	EXPECT_EQ(h.find(1), nullptr);
+	EXPECT_TRUE(s.verify());
+	EXPECT_TRUE(h.verify());
+}
+
+TEST(TableFile, verify_detects_a_damaged_payload)
+{
+	TempPath path("damaged");
+	SortedTable<int, int> t;
+	for (int i = 0; i < 100; ++i)
+		t.insert(i, i);
+	saveTable(path.str(), t);
+	patchByte(path.str(), sizeof(TableFileHeader) + 200, 0x7F);
+
+	MappedSortedTable<int, int> m(path.str());
+	EXPECT_FALSE(m.verify());
+}
+
+TEST(TableFile, open_rejects_foreign_files)
+{
+	TempPath path("foreign");
+	SortedTable<int, int> t;
+	t.insert(1, 2);
+	saveTable(path.str(), t);
+
+	// another kind of table or entry size
+	EXPECT_THROW((MappedHashTable<int, int>(path.str())), std::runtime_error);
+	EXPECT_THROW((MappedSortedTable<int64_t, int>(path.str())), std::runtime_error);
+	EXPECT_NO_THROW((MappedSortedTable<int, int>(path.str())));
+
+	patchByte(path.str(), offsetof(TableFileHeader, version), 2);
+	EXPECT_THROW((MappedSortedTable<int, int>(path.str())), std::runtime_error);
+
+	patchByte(path.str(), 0, 'X');
+	EXPECT_THROW((MappedSortedTable<int, int>(path.str())), std::runtime_error);
+
+	EXPECT_THROW((MappedSortedTable<int, int>(path.str() + ".missing")), std::runtime_error);
+}
+
+TEST(TableFile, open_rejects_truncated_files)
+{
+	TempPath path("truncated");
+	HashTable<int, int> t;
+	for (int i = 0; i < 100; ++i)
+		t.insert(i, i);
+	saveTable(path.str(), t);
+	std::ifstream in(path.str(), std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	std::ofstream(path.str(), std::ios::binary | std::ios::trunc).write(bytes.data(), std::streamsize(bytes.size() - 8));
+
+	EXPECT_THROW((MappedHashTable<int, int>(path.str())), std::runtime_error);
+}
+
+TEST(TableFile, slot_padding_is_written_as_zeros)
+{
+	typedef TableFileSlot<uint64_t, uint8_t> Slot;
+	static_assert(sizeof(Slot) == 16, "the value is followed by 7 bytes of padding");
+	TempPath path("padding");
+	HashTable<uint64_t, uint8_t> t;
+	for (uint64_t i = 0; i < 100; ++i)
+		t.insert(i, uint8_t(i));
+	saveTable(path.str(), t);
+
+	std::ifstream in(path.str(), std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	size_t capacity = 128;
+	ASSERT_EQ(bytes.size(), sizeof(TableFileHeader) + table_file::hashBytes(capacity, sizeof(Slot)));
+	size_t slots = sizeof(TableFileHeader) + table_file::hashSlotsOffset(capacity);
+	for (size_t i = 0; i < capacity; ++i)
+		for (size_t b = offsetof(Slot, value) + 1; b < sizeof(Slot); ++b)
+			ASSERT_EQ(bytes[slots + i * sizeof(Slot) + b], 0) << "slot " << i << " byte " << b;
+}
+
+TEST(TableFile, checksum_of_no_bytes)
+{
+	uint8_t byte = 0x55;
+	EXPECT_EQ(checksum64(nullptr, 0), checksum64(&byte, 0));
+	EXPECT_NE(checksum64(&byte, 1), checksum64(&byte, 0));
+}
+
+TEST(TableFile, lookups_end_on_damaged_control_bytes)
+{
+	TempPath path("damaged_ctrl");
+	HashTable<int, int> t;
+	for (int i = 0; i < 50; ++i)
+		t.insert(i, i);
+	saveTable(path.str(), t);
+	size_t capacity = 64;
+
+	// no EMPTY byte left to end a probe: all tombstones, then all tags
+	for (char fill : { char(SwissControl::DELETED), char(0x05) }) {
+		for (size_t i = 0; i < capacity; ++i)
+			patchByte(path.str(), sizeof(TableFileHeader) + i, fill);
+		MappedHashTable<int, int> m(path.str());
+		EXPECT_FALSE(m.verify());
+		for (int k = 100; k < 200; ++k)
+			EXPECT_EQ(m.find(k), nullptr);
+	}
+}
@@ -1,4 +1,5 @@
 #include "artans.h"
+#include "modint.h"
 #include <gtest.h>
 
 
@@ -146,4 +147,74 @@ TEST(translator, UnaryMinusWithComplexFloatingPointExpression) {
     std::string infix = "-(2.5 * (3.2 - 1.1) + 4.5)";
     double expectedResult = -(2.5 * 2.1 + 4.5);
     EXPECT_EQ(expectedResult, translator.getAnswer(infix));
-}
\ No newline at end of file
+}
+
+TEST(translator, PolynomialFromConstantExpression) {
+    ArithmeticTranslator translator;
+    Polynomial p = translator.ToPolynomial("(4 ^ 2) * (2 + (3 / (2 + 2))) + ((4 * 5) / (2 + 3))");
+    EXPECT_EQ(Polynomial(48), p);
+}
+
+TEST(translator, PolynomialCollectsLikeTerms) {
+    ArithmeticTranslator translator;
+    Polynomial p = translator.ToPolynomial("x + 2*y - x + 3*y");
+    EXPECT_EQ(Polynomial::monomial(5, 0, 1, 0), p);
+}
+
+TEST(translator, PolynomialWithPowerOfSum) {
+    ArithmeticTranslator translator;
+    Polynomial p = translator.ToPolynomial("3*x^2*y - (x+y)^3");
+    Polynomial x = Polynomial::monomial(1, 1, 0, 0);
+    Polynomial y = Polynomial::monomial(1, 0, 1, 0);
+    EXPECT_EQ(3 * x * x * y - (x + y) * (x + y) * (x + y), p);
+    EXPECT_EQ(-1, p.coefficient(3, 0, 0));
+    EXPECT_EQ(0, p.coefficient(2, 1, 0));
+}
+
+TEST(translator, PolynomialUnaryMinusBindsLooserThanPower) {
+    ArithmeticTranslator translator;
+    Polynomial p = translator.ToPolynomial("-z^2");
+    EXPECT_EQ(Polynomial::monomial(-1, 0, 0, 2), p);
+}
+
+TEST(translator, PolynomialPowerIsRightAssociative) {
+    ArithmeticTranslator translator;
+    Polynomial p = translator.ToPolynomial("x^2^3");
+    EXPECT_EQ(Polynomial::monomial(1, 8, 0, 0), p);
+}
+
+TEST(translator, PolynomialDivisionByConstant) {
+    ArithmeticTranslator translator;
+    Polynomial p = translator.ToPolynomial("(2*x + 4) / 2");
+    EXPECT_EQ(Polynomial::monomial(1, 1, 0, 0) + 2, p);
+}
+
+TEST(translator, PolynomialEvaluatesLikeCalculator) {
+    ArithmeticTranslator translator;
+    Polynomial p = translator.ToPolynomial("(x - 1) * (y + 2) - z / 4");
+    EXPECT_EQ(translator.getAnswer("(3 - 1) * (5 + 2) - 8 / 4"), p.evaluate(3, 5, 8));
+}
+
+TEST(translator, PolynomialRejectsInvalidInput) {
+    ArithmeticTranslator translator;
+    ASSERT_ANY_THROW(translator.ToPolynomial("x / y"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("x ^ y"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("x ^ 1.5"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("w + 1"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("2 x"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("(x + 1"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("x + 1)"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("x +"));
+    ASSERT_ANY_THROW(translator.ToPolynomial("x / 0"));
+}
+
+TEST(translator, PolynomialOverResidues) {
+    ArithmeticTranslator translator;
+    BasicPolynomial<ModP61> p = translator.ToPolynomial<ModP61>("(x - 1)^2 / 2 + 2^61");
+    ModP61 half = ModP61(1) / ModP61(2);
+    EXPECT_EQ(half, p.coefficient(2, 0, 0));
+    EXPECT_EQ(ModP61(-1), p.coefficient(1, 0, 0));
+    // 2^61 = 1 (mod 2^61 - 1)
+    EXPECT_EQ(half + ModP61(1), p.coefficient(0, 0, 0));
+    EXPECT_ANY_THROW(translator.ToPolynomial<ModP61>("x + 1.5"));
+}
@@ -0,0 +1,176 @@
+#include "unrolled_list.h"
+#include <gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+
+TEST(UnrolledList, can_create_list_with_size)
+{
+	UnrolledList<int, 4> l(10, 3);
+
+	EXPECT_EQ(l.size(), 10);
+	EXPECT_EQ(l[9], 3);
+}
+
+TEST(UnrolledList, cant_create_list_with_negative_size)
+{
+	ASSERT_ANY_THROW((UnrolledList<int, 4>(-1)));
+}
+
+TEST(UnrolledList, insert_keeps_order_across_node_splits)
+{
+	UnrolledList<int, 4> l;
+	UnrolledList<int, 4>::Iterator it = l.insert_front(0);
+	for (int i = 1; i < 20; ++i)
+		it = l.insert(i, it);
+
+	ASSERT_EQ(l.size(), 20);
+	for (int i = 0; i < 20; ++i)
+		EXPECT_EQ(l[i], i);
+}
+
+TEST(UnrolledList, insert_front_keeps_order)
+{
+	UnrolledList<int, 4> l;
+	for (int i = 0; i < 10; ++i)
+		l.insert_front(i);
+
+	for (int i = 0; i < 10; ++i)
+		EXPECT_EQ(l[i], 9 - i);
+}
+
+TEST(UnrolledList, can_erase_after_position)
+{
+	UnrolledList<int, 4> l;
+	UnrolledList<int, 4>::Iterator it = l.insert_front(0);
+	for (int i = 1; i < 10; ++i)
+		it = l.insert(i, it);
+
+	UnrolledList<int, 4>::Iterator next = l.erase(l.get_index(3));
+
+	EXPECT_EQ(*next, 5);
+	EXPECT_EQ(l.size(), 9);
+	EXPECT_EQ(l[4], 5);
+}
+
+TEST(UnrolledList, cant_erase_after_last_element)
+{
+	UnrolledList<int, 4> l(4);
+
+	ASSERT_ANY_THROW(l.erase(l.get_index(3)));
+}
+
+TEST(UnrolledList, erase_front_empties_list)
+{
+	UnrolledList<int, 4> l(9, 1);
+	while (!l.empty())
+		l.erase_front();
+
+	EXPECT_EQ(l.begin(), l.end());
+	ASSERT_ANY_THROW(l.erase_front());
+}
+
+TEST(UnrolledList, can_find_element)
+{
+	UnrolledList<int, 4> l(9, 1);
+	l[6] = 5;
+
+	EXPECT_EQ(l.find(5), l.get_index(6));
+	EXPECT_EQ(l.find(7), l.end());
+}
+
+TEST(UnrolledList, compares_lists_with_different_node_layout)
+{
+	UnrolledList<int, 4> a;
+	UnrolledList<int, 4>::Iterator it = a.insert_front(1);
+	for (int i = 0; i < 6; ++i)
+		it = a.insert(1, it);
+	UnrolledList<int, 4> b(7, 1);
+
+	EXPECT_TRUE(a == b);
+	b[3] = 2;
+	EXPECT_TRUE(a != b);
+}
+
+TEST(UnrolledList, copy_is_independent)
+{
+	UnrolledList<int, 4> a(6, 2);
+	UnrolledList<int, 4> b(a);
+	b[0] = 1;
+
+	EXPECT_EQ(a[0], 2);
+	EXPECT_EQ(b.size(), 6);
+}
+
+// Element whose assignment throws once assignsLeft runs out, counting live
+// objects (nodes construct all K of theirs up front)
+struct ThrowingAssign {
+	static int assignsLeft;
+	static int live;
+	int v;
+
+	ThrowingAssign(int v = 0) : v(v) { ++live; }
+	ThrowingAssign(const ThrowingAssign& other) : v(other.v) { ++live; }
+	~ThrowingAssign() { --live; }
+
+	ThrowingAssign& operator=(const ThrowingAssign& other) {
+		if (assignsLeft-- == 0)
+			throw std::runtime_error("assignment failed");
+		v = other.v;
+		return *this;
+	}
+};
+
+int ThrowingAssign::assignsLeft = -1;
+int ThrowingAssign::live = 0;
+
+TEST(UnrolledList, copy_that_throws_frees_its_nodes)
+{
+	{
+		UnrolledList<ThrowingAssign, 4> l(10, ThrowingAssign(7));
+		int before = ThrowingAssign::live;
+
+		// fail in the first, a middle and the last node
+		for (int failAt : { 0, 5, 9 }) {
+			ThrowingAssign::assignsLeft = failAt;
+			EXPECT_THROW((UnrolledList<ThrowingAssign, 4>(l)), std::runtime_error);
+			EXPECT_EQ(ThrowingAssign::live, before);
+
+			ThrowingAssign::assignsLeft = failAt;
+			EXPECT_THROW((UnrolledList<ThrowingAssign, 4>(10, ThrowingAssign(1))), std::runtime_error);
+			EXPECT_EQ(ThrowingAssign::live, before);
+		}
+
+		UnrolledList<ThrowingAssign, 4> target(3);
+		ThrowingAssign::assignsLeft = 5;
+		EXPECT_THROW(target = l, std::runtime_error);
+		EXPECT_EQ(target.size(), 0);
+		ThrowingAssign::assignsLeft = -1;
+		target = l;
+		EXPECT_EQ(target.size(), 10);
+		EXPECT_EQ(target[9].v, 7);
+	}
+	EXPECT_EQ(ThrowingAssign::live, 0);
+}
+
+TEST(UnrolledList, iterator_visits_all_elements)
+{
+	UnrolledList<int, 4> l(10, 1);
+	int sum = 0;
+	for (int x : l)
+		sum += x;
+
+	EXPECT_EQ(sum, 10);
+}
+
+TEST(UnrolledList, can_print)
+{
+	UnrolledList<int, 2> l;
+	l.insert_front(3);
+	l.insert_front(2);
+	l.insert_front(1);
+	std::ostringstream out;
+	out << l;
+
+	EXPECT_EQ(out.str(), "1 2 3 ");
+}
@@ -0,0 +1,75 @@
+#include "unsorted_table.h"
+#include <gtest.h>
+#include <map>
+#include <string>
+
+
+// Every key gets the same fingerprint, so lookups fall back to key compares
+struct ConstantHash {
+	size_t operator()(int) const { return 42; }
+};
+
+TEST(UnsortedTable, empty_table_finds_nothing)
+{
+	UnsortedTable<int, int> t;
+
+	EXPECT_TRUE(t.empty());
+	EXPECT_EQ(t.find(0), nullptr);
+	EXPECT_FALSE(t.erase(0));
+}
+
+TEST(UnsortedTable, insert_rejects_duplicates)
+{
+	UnsortedTable<std::string, int> t;
+
+	EXPECT_TRUE(t.insert("x", 1));
+	EXPECT_FALSE(t.insert("x", 2));
+	EXPECT_EQ(t.size(), 1u);
+	EXPECT_EQ(*t.find("x"), 1);
+}
+
+TEST(UnsortedTable, finds_keys_in_every_scan_block)
+{
+	UnsortedTable<int, int> t;
+	for (int i = 0; i < 100; ++i)
+		t.insert(i * 3, i);
+
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_NE(t.find(i * 3), nullptr);
+		EXPECT_EQ(*t.find(i * 3), i);
+		EXPECT_EQ(t.find(i * 3 + 1), nullptr);
+	}
+}
+
+TEST(UnsortedTable, equal_fingerprints_are_resolved_by_key)
+{
+	UnsortedTable<int, int, ConstantHash> t;
+	for (int i = 0; i < 70; ++i)
+		t.insert(i, -i);
+
+	for (int i = 0; i < 70; ++i)
+		EXPECT_EQ(*t.find(i), -i);
+	EXPECT_EQ(t.find(70), nullptr);
+}
+
+TEST(UnsortedTable, erase_moves_last_entry_into_hole)
+{
+	UnsortedTable<int, std::string> t;
+	std::map<int, std::string> ref;
+	for (int i = 0; i < 300; ++i) {
+		int k = (i * 7919) % 97;
+		EXPECT_EQ(t.insert(k, std::to_string(i)), ref.insert(std::make_pair(k, std::to_string(i))).second);
+		if (i % 2 == 0) {
+			int e = (i * 13) % 97;
+			EXPECT_EQ(t.erase(e), ref.erase(e) == 1);
+		}
+	}
+
+	ASSERT_EQ(t.size(), ref.size());
+	size_t visited = 0;
+	t.for_each([&](const int& k, std::string& v) {
+		EXPECT_EQ(ref[k], v);
+		++visited;
+	});
+	EXPECT_EQ(visited, ref.size());
+}